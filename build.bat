@@ -6,11 +6,18 @@ where cl >nul 2>nul
 if %ERRORLEVEL% neq 0 call "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat" >nul
 
 set COMMON_COMPILER_FLAGS= -Zi -nologo -std:c11 -wd5105 -GR-
-set COMMON_LINKER_FLAGS= opengl32.lib user32.lib gdi32.lib dsound.lib
+set COMMON_LINKER_FLAGS= opengl32.lib user32.lib gdi32.lib dsound.lib winmm.lib
 
 if not exist bin mkdir bin
 pushd bin
 
+Rem the game on its own, DEV builds of win32.exe load it and reload it while they run. lock.tmp tells them
+Rem it is still being built. The pdb gets a new name every time because the debugger keeps the loaded one locked.
+del game_*.pdb > NUL 2> NUL
+echo building > lock.tmp
+cl  %COMMON_COMPILER_FLAGS% ..\source\game_module.c -LD /link -incremental:no -PDB:game_%random%.pdb -out:game.dll
+del lock.tmp
+
 cl  %COMMON_COMPILER_FLAGS% ..\source\win32.c /link %COMMON_LINKER_FLAGS% -out:win32.exe
 
 popd
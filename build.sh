@@ -0,0 +1,31 @@
+#!/bin/sh
+
+# @Info: builds the linux platform layer, see the top of source/linux.c for what it can do
+#
+# @Note: the warnings that are off are idioms of the code base, braces are left out when initializing the vector
+#        unions, macros with default arguments override fields that were set before them, the unity build keeps
+#        helpers around that not every build calls and callbacks take parameters they do not all need
+COMMON_COMPILER_FLAGS="-g -std=c11 -Wall -Wextra -Wno-missing-braces -Wno-override-init -Wno-override-init-side-effects \
+                       -Wno-unused-function -Wno-unused-parameter"
+COMMON_LINKER_FLAGS="-lEGL -lm -ldl -lpthread"
+
+mkdir -p bin
+cd bin
+
+# @Info: "./build.sh tests" builds every program in tests/ with optimizations and runs it, see tests/test.h
+if [ "$1" = "tests" ]; then
+    mkdir -p tests
+    failed=0
+    for test in ../tests/*.c; do
+        name=$(basename "$test" .c)
+        cc $COMMON_COMPILER_FLAGS -O2 "$test" -lm -ldl -lpthread -o "tests/$name" || exit 1
+        "./tests/$name" || failed=1
+    done
+    exit $failed
+fi
+
+# @Info: the game on its own, DEV builds of linux load it and reload it while they run. It gets renamed into place,
+#        so they never see half of it.
+cc $COMMON_COMPILER_FLAGS -shared -fPIC -fvisibility=hidden ../source/game_module.c -lm -o game.so.tmp && mv game.so.tmp game.so
+
+cc $COMMON_COMPILER_FLAGS ../source/linux.c $COMMON_LINKER_FLAGS -o linux
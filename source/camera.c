@@ -74,7 +74,6 @@ static void update_editor_camera(game_state* state) {
     
     float cam_rotation_step = 100. * cam_speed;
     float cam_move_step     = 50. * cam_speed; 
-    float cam_up_step       = 3. * cam_speed;
     
     float pitch_limit = 75;
         
@@ -118,6 +117,44 @@ static void update_editor_camera(game_state* state) {
     
     camera_rotate_y_around_point(cam, pivot, cam->params.rotation.y);
     camera_rotate_x_around_point(cam, pivot, cam->params.rotation.x);
+}
+
+// @Info: returns true if the constants had to be rebuilt
+static bool camera_update_constants(camera_constants* constants, camera_info* cam, int window_width, int window_height) {
+    bool changed = !constants->source.valid || constants->source.camera != cam ||
+        constants->source.window_width != window_width || constants->source.window_height != window_height ||
+        constants->source.fov != cam->fov || constants->source.near != cam->near || constants->source.far != cam->far ||
+        !vec_eq(constants->source.position, cam->position) || !vec_eq(constants->source.forward, cam->forward) ||
+        !vec_eq(constants->source.up, cam->up) || !vec_eq(constants->source.right, cam->right);
+    
+    if (!changed) { return false; }
+    
+    bool projection_changed = !constants->source.valid || 
+        constants->source.window_width != window_width || constants->source.window_height != window_height ||
+        constants->source.fov != cam->fov || constants->source.near != cam->near || constants->source.far != cam->far;
+    
+    if (projection_changed) {
+        constants->projection = make_projection_matrix(window_width, window_height, cam->fov, cam->near, cam->far);
+        constants->inverse_projection = mat4_inv_perspective(constants->projection);
+    }
+    
+    constants->view = make_view_matrix_from_camera(cam);
+    constants->inverse_view = mat4_inv_rigid(constants->view);
+    
+    constants->view_projection = mat4_mul(constants->projection, constants->view);
+    constants->inverse_view_projection = mat4_mul(constants->inverse_view, constants->inverse_projection);
+    
+    constants->source.valid         = true;
+    constants->source.camera        = cam;
+    constants->source.position      = cam->position;
+    constants->source.forward       = cam->forward;
+    constants->source.up            = cam->up;
+    constants->source.right         = cam->right;
+    constants->source.fov           = cam->fov;
+    constants->source.near          = cam->near;
+    constants->source.far           = cam->far;
+    constants->source.window_width  = window_width;
+    constants->source.window_height = window_height;
     
-    cam->view_matrix = make_view_matrix_from_camera(cam);
+    return true;
 }
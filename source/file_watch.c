@@ -0,0 +1,190 @@
+#pragma once
+
+// @Info: the part of file watching both platform layers share. A watcher thread from the platform layer waits on
+//        every directory that has a watched file in it and hands the names of files written in there to
+//        file_watch_note_change. Once a file has been quiet for FILE_WATCH_DEBOUNCE_MS the change goes into a
+//        queue that the main thread drains in check_file_watchers, which is where the callbacks run.
+//
+//        The watch list belongs to the main thread, the watcher thread only knows about directories. Directories
+//        stay watched once they are, platform_clear_file_watches only drops the watches. The platform layer's own
+//        watches come first and survive it, see file_watch_keep_current.
+
+#define MAX_FILE_WATCH_COUNT        128
+#define MAX_WATCHED_DIRECTORY_COUNT 16
+#define MAX_PENDING_FILE_CHANGES    64
+#define FILE_CHANGE_QUEUE_SIZE      64  // power of two
+#define FILE_WATCH_NAME_LENGTH      64
+#define FILE_WATCH_DEBOUNCE_MS      100 // @Info: programs write files in more than one go, this waits for the last one
+
+typedef struct {
+    u32 directory;
+    u32 name_length;
+    char name[FILE_WATCH_NAME_LENGTH];
+} file_change;
+
+// @Info: single producer (watcher thread), single consumer (main thread), no locks. Each side only writes its
+//        own index and publishes it with a release store.
+typedef struct {
+    file_change entries[FILE_CHANGE_QUEUE_SIZE];
+    volatile u32 read;
+    volatile u32 write;
+} file_change_queue;
+
+typedef struct {
+    file_change change;
+    u64 deadline;
+} pending_file_change;
+
+typedef struct {
+    u32 directory;
+    string path;
+    string name;
+    void (*callback)(string, void*);
+    void* data;
+} file_watch_info;
+
+typedef struct {
+    char path[256];
+    u32 length;
+} watched_directory_info;
+
+// @Note: main thread only
+file_watch_info file_watches[MAX_FILE_WATCH_COUNT];
+int file_watch_count;
+int kept_file_watch_count;
+
+// @Note: the main thread fills in a directory before it publishes the new count
+watched_directory_info watched_directories[MAX_WATCHED_DIRECTORY_COUNT];
+volatile u32 watched_directory_count;
+
+file_change_queue file_changes;
+
+// @Note: watcher thread only
+pending_file_change pending_file_changes[MAX_PENDING_FILE_CHANGES];
+int pending_file_change_count;
+
+// @Info: the directory includes the trailing slash, it is "" for a path without one
+static void file_watch_split_path(string path, string* directory, string* name) {
+    int split = path.length;
+    while (split > 0 && path.data[split - 1] != '/' && path.data[split - 1] != '\\') { split--; }
+    
+    *directory = (string){ .data = path.data, .length = split };
+    *name = (string){ .data = path.data + split, .length = path.length - split };
+}
+
+// @Info: -1 if nothing in the directory is watched yet
+static int file_watch_find_directory(string directory) {
+    for (u32 i = 0; i < watched_directory_count; i++) {
+        watched_directory_info* info = &watched_directories[i];
+        if (string_compare((string){ .data = info->path, .length = info->length }, directory)) { return i; }
+    }
+    
+    return -1;
+}
+
+// @Info: called by the main thread once the platform is waiting on the directory, returns its index
+static int file_watch_publish_directory(string directory) {
+    u32 index = watched_directory_count;
+    assert(index < MAX_WATCHED_DIRECTORY_COUNT);
+    assert(directory.length < sizeof(watched_directories[index].path));
+    
+    memory_copy(watched_directories[index].path, directory.data, directory.length);
+    watched_directories[index].path[directory.length] = 0;
+    watched_directories[index].length = directory.length;
+    
+    store_release(&watched_directory_count, index + 1);
+    return index;
+}
+
+static void file_watch_add(u32 directory, string path, string name, void (*callback)(string, void*), void* data) {
+    assert(MAX_FILE_WATCH_COUNT > file_watch_count);
+    file_watches[file_watch_count++] = (file_watch_info){
+        .directory = directory,
+        .path = path,
+        .name = name,
+        .callback = callback,
+        .data = data };
+}
+
+// @Info: the watches there are so far stay when the game clears its watches, for the platform layer's own
+static void file_watch_keep_current() {
+    kept_file_watch_count = file_watch_count;
+}
+
+static void file_watch_clear() {
+    file_watch_count = kept_file_watch_count;
+}
+
+// @Info: watcher thread, another change to the same file pushes the deadline back
+static void file_watch_note_change(u32 directory, char* name, u32 name_length, u64 now) {
+    if (name_length > FILE_WATCH_NAME_LENGTH) { return; } // @Note: can't be one of ours, we only watch files we know
+    
+    pending_file_change* pending = 0;
+    for (int i = 0; i < pending_file_change_count; i++) {
+        file_change* change = &pending_file_changes[i].change;
+        if (change->directory == directory && change->name_length == name_length &&
+            memcmp(change->name, name, name_length) == 0) {
+            pending = &pending_file_changes[i];
+            break;
+        }
+    }
+    
+    if (!pending) {
+        if (pending_file_change_count == MAX_PENDING_FILE_CHANGES) { return; }
+        
+        pending = &pending_file_changes[pending_file_change_count++];
+        pending->change.directory = directory;
+        pending->change.name_length = name_length;
+        memory_copy(pending->change.name, name, name_length);
+    }
+    
+    pending->deadline = now + FILE_WATCH_DEBOUNCE_MS;
+}
+
+// @Info: watcher thread, queues the changes that have settled. Returns how many milliseconds it can wait before
+//        it has to be called again, or -1 (forever) if nothing is pending.
+static u64 file_watch_flush_pending(u64 now) {
+    u64 wait = (u64)-1;
+    
+    for (int i = 0; i < pending_file_change_count; ) {
+        pending_file_change* pending = &pending_file_changes[i];
+        
+        if (pending->deadline > now) {
+            wait = MIN(wait, pending->deadline - now);
+            i++;
+            continue;
+        }
+        
+        u32 write = file_changes.write;
+        if (write - load_acquire(&file_changes.read) == FILE_CHANGE_QUEUE_SIZE) {
+            wait = MIN(wait, FILE_WATCH_DEBOUNCE_MS); // @Note: full, the main thread is not running frames right now
+            i++;
+            continue;
+        }
+        
+        file_changes.entries[write & (FILE_CHANGE_QUEUE_SIZE - 1)] = pending->change;
+        store_release(&file_changes.write, write + 1);
+        
+        *pending = pending_file_changes[--pending_file_change_count];
+    }
+    
+    return wait;
+}
+
+// @Info: main thread, once per frame. Costs one load when nothing changed.
+static void check_file_watchers() {
+    u32 write = load_acquire(&file_changes.write);
+    
+    for (u32 read = file_changes.read; read != write; read++) {
+        file_change change = file_changes.entries[read & (FILE_CHANGE_QUEUE_SIZE - 1)];
+        store_release(&file_changes.read, read + 1);
+        
+        string name = { .data = change.name, .length = change.name_length };
+        for (int i = 0; i < file_watch_count; i++) {
+            file_watch_info* watch = &file_watches[i];
+            if (watch->directory == change.directory && string_compare(watch->name, name)) {
+                watch->callback(watch->path, watch->data);
+            }
+        }
+    }
+}
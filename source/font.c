@@ -10,6 +10,27 @@ void init_font(game_state* state) {
     result.glyph_height = 8;
     result.glyph_count = result.texture->w / result.glyph_width;
     
+    text_layout_cache* layouts = push_struct(&global->permanent_arena, text_layout_cache);
+    layouts->count = 0;
+    layouts->lru_first = layouts->lru_last = -1;
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_BUCKETS; i++) { layouts->buckets[i] = -1; }
+    result.layouts = layouts;
+    
+    // @Info: glyph quads get streamed into this buffer, one draw call per text
+    glGenVertexArrays(1, &result.vao);
+    glGenBuffers(1, &result.vbo);
+    glBindVertexArray(result.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, result.vbo);
+    
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glyph_vertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glyph_vertex), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
     state->font = result;
 }
 
@@ -22,28 +43,6 @@ static inline int get_text_width_single_line(string text, int height) {
     return scale * text.length * global->font.x_advance;
 }
 
-static ivec2 font_get_rendered_text_dimensions(string text, int height) {
-    float scale = get_font_scale_for_pixel_height(height);
-    ivec2 result = { .w = 0, .h = height };
-    
-    int current_line_w = 0;
-    int advance = global->font.x_advance * scale;
-    
-    for (int i = 0; i < text.length; i++) {
-        if (text.data[i] == '\n') { 
-            result.h += height;
-            current_line_w = 0;
-        } else {
-            current_line_w += advance;
-            if (current_line_w > result.w) { 
-                result.w = current_line_w;
-            }
-        }
-    }    
-
-    return result;
-}
-
 typedef struct {
     int count;
     int height;
@@ -65,66 +64,198 @@ typedef struct {
 #define render_text(TEXT, X, Y, ...) _render_text(TEXT, X, Y,\
     (render_text_args){ .count = (TEXT).length, default_render_args, __VA_ARGS__ })
 
-// @Info: this returns the position where the text stops
-vec2 _render_text(string text, int x, int y, render_text_args args) {
+// @Info: writes 6 vertices per glyph if vertices is not 0. Glyphs are placed by their center, so everything is 
+//        moved by half a glyph. A line break takes the place of the glyph that did not fit anymore.
+static text_layout_info font_layout_text(string text, render_text_args args, glyph_vertex* vertices) {
     font_info* font = &global->font;
-    shader_info* shader = get_shader("font_glyph");
-    
-    float window_w = global->platform->window_width;
-    float window_h = global->platform->window_height;
     
     float scale = get_font_scale_for_pixel_height(args.height);
     float scaled_width = font->glyph_width * scale;
-    
-    glUseProgram(shader->id);
-    shader_bind_texture(shader, font->texture, "font", 0);
-    
+    float half_width = scaled_width / 2.f;
+    float half_height = args.height / 2.f;
     float u_span = 1.f / (float)font->glyph_count;
-    shader_set_uniform(shader, "u_span", u_span);
-    
-    shader_set_uniform(shader, "color", args.color);
-    shader_set_uniform(shader, "scale", vec2(scaled_width / window_w, args.height / window_h));
     
-    glBindVertexArray(global->renderer.quad_mesh.vao);
+    text_layout_info result = { .dimensions = { .w = 0, .h = args.height } };
     
-    // @Info: This is needed since the base quad is centered at (x, y)
-    x += scaled_width / 2.f;
-    y += font->glyph_height / 2.f * scale;
+    float x = half_width;
+    float y = half_height;
     
-    int cur_x = x;
+    float cur_x = x;
     int cur_width = 0;
     int cur_height = 0;
-    for (int i = 0; i < args.count; i++) {
+    for (u32 i = 0; i < text.length; i++) {
         char c = text.data[i];
         
         cur_width += font->x_advance * scale;
         
-        if (c == '\n' || cur_width >= args.break_after_width) {
+        if (c == '\n' || (u32)cur_width >= args.break_after_width) {
             y += args.height;
             cur_x = x;
             cur_width = 0;
             cur_height += args.height;
+            result.dimensions.h += args.height;
             continue;
         }
         
-        if (cur_height >= args.clamp_after_height) { break; }
-        if (cur_width >= args.clamp_after_width) { break; }
+        if ((u32)cur_height >= args.clamp_after_height) { break; }
+        if ((u32)cur_width >= args.clamp_after_width) { break; }
         
-        int glyph_index = c - 32;
-        float u_off = glyph_index / (float)font->glyph_count;
-        shader_set_uniform(shader, "u_off", u_off);
-        shader_set_uniform(shader, "offset", screen_to_ndc(vec2(cur_x, y)));
+        if (vertices) {
+            float u0 = (c - 32) * u_span;
+            float u1 = u0 + u_span;
+            
+            // @Note: v is 0 at the bottom of the glyph
+            glyph_vertex bottom_left  = { vec2(cur_x - half_width, y + half_height), vec2(u0, 0) };
+            glyph_vertex bottom_right = { vec2(cur_x + half_width, y + half_height), vec2(u1, 0) };
+            glyph_vertex top_right    = { vec2(cur_x + half_width, y - half_height), vec2(u1, 1) };
+            glyph_vertex top_left     = { vec2(cur_x - half_width, y - half_height), vec2(u0, 1) };
+            
+            glyph_vertex* v = vertices + result.glyph_count * 6;
+            v[0] = bottom_left;
+            v[1] = bottom_right;
+            v[2] = top_right;
+            v[3] = bottom_left;
+            v[4] = top_right;
+            v[5] = top_left;
+        }
         
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        result.glyph_count++;
+        result.dimensions.w = MAX(result.dimensions.w, cur_width);
         
         cur_x = x + cur_width; 
     }
     
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glUseProgram(0);
+    result.end = vec2(cur_x, y);
+    
+    return result;
+}
+
+static void text_layout_lru_unlink(text_layout_cache* cache, int index) {
+    text_layout* layout = &cache->entries[index];
+    
+    if (layout->lru_prev >= 0) { cache->entries[layout->lru_prev].lru_next = layout->lru_next; }
+    else                       { cache->lru_first = layout->lru_next; }
+    
+    if (layout->lru_next >= 0) { cache->entries[layout->lru_next].lru_prev = layout->lru_prev; }
+    else                       { cache->lru_last = layout->lru_prev; }
+}
+
+static void text_layout_lru_push_front(text_layout_cache* cache, int index) {
+    text_layout* layout = &cache->entries[index];
+    
+    layout->lru_prev = -1;
+    layout->lru_next = cache->lru_first;
+    
+    if (cache->lru_first >= 0) { cache->entries[cache->lru_first].lru_prev = index; }
+    else                       { cache->lru_last = index; }
+    
+    cache->lru_first = index;
+}
+
+// @Info: returns the layout of text from the cache, laying it out on a miss. *vertices points into the cache, 
+//        or into transient memory for text longer than TEXT_LAYOUT_MAX_LENGTH.
+static text_layout_info font_get_text_layout(string text, render_text_args args, glyph_vertex** vertices) {
+    if (text.length > TEXT_LAYOUT_MAX_LENGTH) {
+        *vertices = push_array(&global->transient_arena, glyph_vertex, text.length * 6);
+        return font_layout_text(text, args, *vertices);
+    }
+    
+    text_layout_cache* cache = global->font.layouts;
+    
+    u32 hash = string_hash(text);
+    s16* bucket = &cache->buckets[hash & (TEXT_LAYOUT_CACHE_BUCKETS - 1)];
+    
+    for (int index = *bucket; index >= 0; index = cache->entries[index].bucket_next) {
+        text_layout* layout = &cache->entries[index];
+        
+        bool hit = layout->hash == hash && layout->height == args.height 
+            && layout->break_after_width == args.break_after_width
+            && layout->clamp_after_width == args.clamp_after_width
+            && layout->clamp_after_height == args.clamp_after_height
+            && string_compare(text, (string){ layout->text, layout->text_length, layout->text_length });
+        
+        if (hit) {
+            text_layout_lru_unlink(cache, index);
+            text_layout_lru_push_front(cache, index);
+            
+            *vertices = layout->vertices;
+            return layout->info;
+        }
+    }
+    
+    int index;
+    if (cache->count < TEXT_LAYOUT_CACHE_SIZE) {
+        index = cache->count++;
+    } else {
+        // reuse the least recently used one, it has to leave its bucket first
+        index = cache->lru_last;
+        text_layout* evicted = &cache->entries[index];
+        
+        s16* link = &cache->buckets[evicted->hash & (TEXT_LAYOUT_CACHE_BUCKETS - 1)];
+        while (*link != index) { link = &cache->entries[*link].bucket_next; }
+        *link = evicted->bucket_next;
+        
+        text_layout_lru_unlink(cache, index);
+    }
+    
+    text_layout* layout = &cache->entries[index];
+    layout->hash = hash;
+    layout->height = args.height;
+    layout->break_after_width = args.break_after_width;
+    layout->clamp_after_width = args.clamp_after_width;
+    layout->clamp_after_height = args.clamp_after_height;
+    layout->text_length = text.length;
+    memory_copy(layout->text, text.data, text.length);
+    
+    layout->info = font_layout_text(text, args, layout->vertices);
+    
+    layout->bucket_next = *bucket;
+    *bucket = index;
+    text_layout_lru_push_front(cache, index);
+    
+    *vertices = layout->vertices;
+    return layout->info;
+}
+
+static ivec2 font_get_rendered_text_dimensions(string text, int height) {
+    glyph_vertex* vertices;
+    text_layout_info layout = font_get_text_layout(text, (render_text_args){ .count = text.length, default_render_args, 
+                                                                            .height = height }, &vertices);
+    return layout.dimensions;
+}
+
+// @Info: this returns the position where the text stops
+vec2 _render_text(string text, int x, int y, render_text_args args) {
+    font_info* font = &global->font;
+    
+    text.length = MIN(text.length, (u32)args.count);
+    
+    glyph_vertex* vertices;
+    text_layout_info layout = font_get_text_layout(text, args, &vertices);
+    
+    if (layout.glyph_count) {
+        shader_info* shader = get_shader("font_glyph");
+        
+        glUseProgram(shader->id);
+        shader_bind_texture(shader, font->texture, "font", 0);
+        
+        shader_set_uniform(shader, "color", args.color);
+        shader_set_uniform(shader, "origin", vec2(x, y));
+        shader_set_uniform(shader, "window_size", vec2(global->platform->window_width, global->platform->window_height));
+        
+        glBindVertexArray(font->vao);
+        glBindBuffer(GL_ARRAY_BUFFER, font->vbo);
+        glBufferData(GL_ARRAY_BUFFER, layout.glyph_count * 6 * sizeof(glyph_vertex), vertices, GL_STREAM_DRAW);
+        
+        glDrawArrays(GL_TRIANGLES, 0, layout.glyph_count * 6);
+        
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+    }
     
-    return vec2(cur_x, y);
+    return vec2(x + layout.end.x, y + layout.end.y);
 }
 
 
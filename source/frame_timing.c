@@ -0,0 +1,103 @@
+#pragma once
+
+// @Info: the frame limiter and the frame time statistics both platform layers share, on top of
+//        platform_get_ticks and platform_sleep. The limiter sleeps while it can trust platform_sleep to come back
+//        in time and spins for the rest, so frames start within a few microseconds of the target.
+
+#define FRAME_TIME_HISTORY_COUNT 256
+#define FRAME_TIME_STATS_INTERVAL 64    // @Info: frames between updates of platform_info.frame_times
+
+typedef struct {
+    u64 ticks_per_second;
+    u64 target_ticks;       // @Info: from one frame start to the next, 0 lets frames run as fast as they can
+    u32 target_frame_rate;
+    
+    u64 longest_sleep;      // @Info: what platform_sleep(1) took at worst lately, decays so one hiccup does not stick
+    
+    u64 frame_start;
+    
+    float history[FRAME_TIME_HISTORY_COUNT];    // @Info: milliseconds from one frame start to the next
+    u32 history_count;
+    u32 history_next;
+} frame_timer;
+
+static void frame_timer_set_rate(frame_timer* timer, u32 target_frame_rate) {
+    timer->target_frame_rate = target_frame_rate;
+    timer->target_ticks = target_frame_rate ? timer->ticks_per_second / target_frame_rate : 0;
+}
+
+static void init_frame_timer(frame_timer* timer, u32 target_frame_rate) {
+    *timer = (frame_timer){ 0 };
+    
+    timer->ticks_per_second = platform_get_tick_frequency();
+    timer->longest_sleep = timer->ticks_per_second / 500;
+    timer->frame_start = platform_get_ticks();
+    
+    frame_timer_set_rate(timer, target_frame_rate);
+}
+
+// @Info: call first thing in a frame, returns the ticks since the last frame started
+static u64 frame_timer_begin_frame(frame_timer* timer) {
+    u64 now = platform_get_ticks();
+    u64 dt = now - timer->frame_start;
+    timer->frame_start = now;
+    
+    timer->history[timer->history_next] = dt * 1000.0 / timer->ticks_per_second;
+    timer->history_next = (timer->history_next + 1) % FRAME_TIME_HISTORY_COUNT;
+    timer->history_count = MIN(timer->history_count + 1, FRAME_TIME_HISTORY_COUNT);
+    
+    return dt;
+}
+
+// @Info: call last thing in a frame, returns once the next one is due
+static void frame_timer_wait(frame_timer* timer) {
+    if (!timer->target_ticks) { return; }
+    
+    u64 target = timer->frame_start + timer->target_ticks;
+    
+    while (true) {
+        u64 now = platform_get_ticks();
+        if (now >= target) { break; }
+        
+        if (target - now > timer->longest_sleep) {
+            platform_sleep(1);
+            
+            u64 slept = platform_get_ticks() - now;
+            timer->longest_sleep = MAX(slept, timer->longest_sleep - timer->longest_sleep / 64);
+        }
+    }
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float x = *(float*)a, y = *(float*)b;
+    return (x > y) - (x < y);
+}
+
+static frame_time_stats frame_timer_get_stats(frame_timer* timer) {
+    frame_time_stats result = { .sample_count = timer->history_count };
+    if (!timer->history_count) { return result; }
+    
+    float sorted[FRAME_TIME_HISTORY_COUNT];
+    memory_copy((char*)sorted, (char*)timer->history, timer->history_count * sizeof(float));
+    qsort(sorted, timer->history_count, sizeof(float), compare_floats);
+    
+    u32 last = timer->history_count - 1;
+    result.p50   = sorted[last * 50 / 100];
+    result.p95   = sorted[last * 95 / 100];
+    result.p99   = sorted[last * 99 / 100];
+    result.worst = sorted[last];
+    
+    return result;
+}
+
+// @Info: before game_update_and_render, also picks up a target_frame_rate the game changed
+static void frame_timer_begin_platform_frame(frame_timer* timer, platform_info* platform) {
+    if (platform->target_frame_rate != timer->target_frame_rate) { frame_timer_set_rate(timer, platform->target_frame_rate); }
+    
+    platform->ticks_per_second = timer->ticks_per_second;
+    platform->dt_ticks = frame_timer_begin_frame(timer);
+    platform->current_ticks = timer->frame_start;
+    platform->dt_ms = platform->dt_ticks * 1000.0 / timer->ticks_per_second;
+    
+    if (timer->history_next % FRAME_TIME_STATS_INTERVAL == 0) { platform->frame_times = frame_timer_get_stats(timer); }
+}
@@ -26,6 +26,16 @@ static inline void* push_permanent(size_t size) {
 static inline void* push_transient(size_t size) {
     return push_size(&global->transient_arena, size);
 } 
+// @Info: stays valid during the next frame as well
+static inline void* push_double_buffered(size_t size) {
+    return push_size(&global->double_buffered_arenas[global->double_buffered_index], size);
+} 
+
+// @Note: direct calls go through these so that memory tracking sees their call site, passing the names 
+//        as allocators still gets the functions above
+#define push_permanent(size)       push_size(&global->permanent_arena, size)
+#define push_transient(size)       push_size(&global->transient_arena, size)
+#define push_double_buffered(size) push_size(&global->double_buffered_arenas[global->double_buffered_index], size)
 
 static inline string push_string(memory_arena* arena, u32 size) {
     return (string) {
@@ -92,30 +102,23 @@ static void sort(void* array, int count, int element_size, bool (*compare)(void*
     }
 }
 
-static void add_event(platform_info* platform, event_info e) {
-    if (platform->event_count + 1 > MAX_EVENT_COUNT) {
-        report("Event buffer is full\n");
-    } else {
-        platform->events[platform->event_count++] = e;
-    }
-}
-
-static void update_time_info(time_info* time, float dt_ms) {
-    time->realtime_dt_ms = dt_ms;
+static void update_time_info(time_info* time, u64 dt_ticks, u64 ticks_per_second) {
+    time->realtime_dt_ms = dt_ticks * 1000.0 / ticks_per_second;
     time->realtime_dt    = time->realtime_dt_ms / 1000.f;
     
     time->dt_ms = time->realtime_dt_ms * time->simulation_speed;
     time->dt    = time->dt_ms / 1000.f;
     
-    time->in_milliseconds += time->dt_ms;
-    time->in_seconds      += time->dt;
+    time->ticks += (u64)(dt_ticks * (double)time->simulation_speed);
+    time->ticks_per_second = ticks_per_second;
     
-    if (time->last_second + 1 < time->in_seconds) {
-        time->once_per_second = true;
-        time->last_second++;
-    } else {
-        time->once_per_second = false;
-    }
+    double seconds = (double)time->ticks / ticks_per_second;
+    time->in_seconds      = seconds;
+    time->in_milliseconds = seconds * 1000.0;
+    
+    u32 second = (u32)seconds;
+    time->once_per_second = second != time->last_second;
+    time->last_second = second;
 }
 
 static inline vec2 screen_to_ndc(vec2 screen) {
@@ -135,74 +138,164 @@ static vec3 ray_from_screen(vec2 screen) {
     vec2 ndc = screen_to_ndc(screen);
     vec4 clip_space = vec4(ndc.x, ndc.y, -1, 1);
     
-    mat4 inverse_projection = mat4_inv(global->renderer.projection_matrix);
-    
-    vec4 temp = vec_transform(inverse_projection, clip_space);
+    vec4 temp = vec_transform(global->renderer.camera.inverse_projection, clip_space);
     vec4 eye_space = vec4(temp.x, temp.y, -1, 0);
     
-    mat4 inverse_view = mat4_inv(global->current_camera->view_matrix);
-    vec3 result = vec_transform(inverse_view, eye_space).xyz;
+    vec3 result = vec_transform(global->renderer.camera.inverse_view, eye_space).xyz;
     
     result = vec_norm(result);
     
     return result;
 }
 
-static float intersect_ray_plane(vec3 ray_origin, vec3 ray_dir, vec3 plane_origin, vec3 plane_normal) {
-    float dot = vec_dot(ray_dir, plane_normal);
-    if (ABS(dot) == 0) { return -1.; }
-
-    float result = vec_dot(vec_sub(plane_origin, ray_origin), plane_normal) / dot;
-
-    return result;
+// @Info: axis-aligned boxes in structure-of-arrays layout for intersect_ray_boxes. 
+//        The arrays have to be allocated to a multiple of RAY_BOX_BATCH_WIDTH, the kernel always loads full batches
+//        (what is past count is ignored).
+#define RAY_BOX_BATCH_WIDTH 8
+#define ray_box_batch_capacity(n) (((n) + RAY_BOX_BATCH_WIDTH - 1) / RAY_BOX_BATCH_WIDTH * RAY_BOX_BATCH_WIDTH)
+
+typedef struct {
+    float* min_x; float* min_y; float* min_z;
+    float* max_x; float* max_y; float* max_z;
+    int count;
+} ray_box_batch;
+
+typedef struct {
+    int index; // -1 if no box was hit
+    float distance;
+    vec3 normal;
+} ray_box_hit;
+
+#if VECTOR_SIMD_SSE
+static inline __m128 simd_select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
 }
-
-
-// @Info: we get the intersection between the ray and the plan the quad is on 
-//        and check if the intersection point is between the quads defining points
-static float intersect_ray_quad(vec3 ray_origin, vec3 ray_dir, collision_quad quad) {
-    // @Speed: i feel like most of the branches could go.. 
-    // @Note: since the quad is axis-aligned, the normal is the axis where quad.min and quad.max are the same
-    vec3 plane_normal = quad.a.x == quad.b.x ? vec3(1, 0, 0) :
-                        quad.a.y == quad.b.y ? vec3(0, 1, 0) :
-                        vec3(0, 0, 1);
-                        
-    float distance_to_plane = intersect_ray_plane(ray_origin, ray_dir, quad.a, plane_normal);
-    vec3 intersection = vec_add(vec_mul(ray_dir, distance_to_plane), ray_origin);
+#endif
+
+// @Info: slab test of one ray against all boxes, returns the nearest hit closer than max_distance.
+//        If the ray starts inside a box, the hit is where it leaves that box. On equal distances the lower index wins.
+static ray_box_hit intersect_ray_boxes(vec3 ray_origin, vec3 ray_dir, ray_box_batch boxes, float max_distance) {
+    ray_box_hit result = { .index = -1, .distance = max_distance };
+    
+    // @Note: a zero component gives +-inf here, which is what the slab test wants
+    vec3 inv_dir = vec3(1.f / ray_dir.x, 1.f / ray_dir.y, 1.f / ray_dir.z);
+    
+#if VECTOR_SIMD_AVX2
+    __m256 ox = _mm256_set1_ps(ray_origin.x), oy = _mm256_set1_ps(ray_origin.y), oz = _mm256_set1_ps(ray_origin.z);
+    __m256 ix = _mm256_set1_ps(inv_dir.x),    iy = _mm256_set1_ps(inv_dir.y),    iz = _mm256_set1_ps(inv_dir.z);
+    __m256 zero = _mm256_setzero_ps();
+    
+    __m256 best_t = _mm256_set1_ps(max_distance);
+    __m256i best_index = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i count = _mm256_set1_epi32(boxes.count);
+    
+    for (int i = 0; i < boxes.count; i += 8) {
+        __m256 tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.min_x + i), ox), ix);
+        __m256 tx2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.max_x + i), ox), ix);
+        __m256 ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.min_y + i), oy), iy);
+        __m256 ty2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.max_y + i), oy), iy);
+        __m256 tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.min_z + i), oz), iz);
+        __m256 tz2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boxes.max_z + i), oz), iz);
+        
+        __m256 t_near = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx1, tx2), _mm256_min_ps(ty1, ty2)), _mm256_min_ps(tz1, tz2));
+        __m256 t_far  = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx1, tx2), _mm256_max_ps(ty1, ty2)), _mm256_max_ps(tz1, tz2));
+        __m256 t = _mm256_blendv_ps(t_near, t_far, _mm256_cmp_ps(t_near, zero, _CMP_LT_OQ));
+        
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(t_near, t_far, _CMP_LE_OQ), _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, best_t, _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_castsi256_ps(_mm256_cmpgt_epi32(count, index)));
+        
+        best_t = _mm256_blendv_ps(best_t, t, hit);
+        best_index = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(best_index), _mm256_castsi256_ps(index), hit));
+        index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+    }
     
-    bool in_quad = false;
+    float lane_t[8];
+    int lane_index[8];
+    _mm256_storeu_ps(lane_t, best_t);
+    _mm256_storeu_si256((__m256i*)lane_index, best_index);
+    int lane_count = 8;
+#elif VECTOR_SIMD_SSE
+    __m128 ox = _mm_set1_ps(ray_origin.x), oy = _mm_set1_ps(ray_origin.y), oz = _mm_set1_ps(ray_origin.z);
+    __m128 ix = _mm_set1_ps(inv_dir.x),    iy = _mm_set1_ps(inv_dir.y),    iz = _mm_set1_ps(inv_dir.z);
+    __m128 zero = _mm_setzero_ps();
+    
+    __m128 best_t = _mm_set1_ps(max_distance);
+    __m128i best_index = _mm_set1_epi32(-1);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i count = _mm_set1_epi32(boxes.count);
+    
+    for (int i = 0; i < boxes.count; i += 4) {
+        __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.min_x + i), ox), ix);
+        __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.max_x + i), ox), ix);
+        __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.min_y + i), oy), iy);
+        __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.max_y + i), oy), iy);
+        __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.min_z + i), oz), iz);
+        __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boxes.max_z + i), oz), iz);
+        
+        __m128 t_near = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)), _mm_min_ps(tz1, tz2));
+        __m128 t_far  = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_max_ps(tz1, tz2));
+        __m128 t = simd_select(_mm_cmplt_ps(t_near, zero), t_far, t_near);
+        
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(t_near, t_far), _mm_cmpge_ps(t, zero));
+        hit = _mm_and_ps(hit, _mm_cmplt_ps(t, best_t));
+        hit = _mm_and_ps(hit, _mm_castsi128_ps(_mm_cmpgt_epi32(count, index)));
+        
+        best_t = simd_select(hit, t, best_t);
+        best_index = _mm_castps_si128(simd_select(hit, _mm_castsi128_ps(index), _mm_castsi128_ps(best_index)));
+        index = _mm_add_epi32(index, _mm_set1_epi32(4));
+    }
     
-    if (plane_normal.x == 1.f) {
-        float min_y = quad.a.y < quad.b.y ? quad.a.y : quad.b.y;
-        float min_z = quad.a.z < quad.b.z ? quad.a.z : quad.b.z;
-        
-        float max_y = quad.a.y > quad.b.y ? quad.a.y : quad.b.y;
-        float max_z = quad.a.z > quad.b.z ? quad.a.z : quad.b.z;
-        
-        in_quad = (min_y <= intersection.y) && (min_z <= intersection.z) 
-            && (max_y >= intersection.y) && (max_z >= intersection.z);
-    } else if (plane_normal.y == 1.f) {
-        float min_x = quad.a.x < quad.b.x ? quad.a.x : quad.b.x;
-        float min_z = quad.a.z < quad.b.z ? quad.a.z : quad.b.z;
-        
-        float max_x = quad.a.x > quad.b.x ? quad.a.x : quad.b.x;
-        float max_z = quad.a.z > quad.b.z ? quad.a.z : quad.b.z;
-        
-        in_quad = (min_x <= intersection.x) && (min_z <= intersection.z) 
-            && (max_x >= intersection.x) && (max_z >= intersection.z);
-    } else {
-        float min_x = quad.a.x < quad.b.x ? quad.a.x : quad.b.x;
-        float min_y = quad.a.y < quad.b.y ? quad.a.y : quad.b.y;
-        
-        float max_x = quad.a.x > quad.b.x ? quad.a.x : quad.b.x;
-        float max_y = quad.a.y > quad.b.y ? quad.a.y : quad.b.y;
+    float lane_t[4];
+    int lane_index[4];
+    _mm_storeu_ps(lane_t, best_t);
+    _mm_storeu_si128((__m128i*)lane_index, best_index);
+    int lane_count = 4;
+#else
+    float lane_t[1] = { max_distance };
+    int lane_index[1] = { -1 };
+    int lane_count = 1;
+    
+    for (int i = 0; i < boxes.count; i++) {
+        float tx1 = (boxes.min_x[i] - ray_origin.x) * inv_dir.x, tx2 = (boxes.max_x[i] - ray_origin.x) * inv_dir.x;
+        float ty1 = (boxes.min_y[i] - ray_origin.y) * inv_dir.y, ty2 = (boxes.max_y[i] - ray_origin.y) * inv_dir.y;
+        float tz1 = (boxes.min_z[i] - ray_origin.z) * inv_dir.z, tz2 = (boxes.max_z[i] - ray_origin.z) * inv_dir.z;
+        
+        float t_near = MAX(MAX(MIN(tx1, tx2), MIN(ty1, ty2)), MIN(tz1, tz2));
+        float t_far  = MIN(MIN(MAX(tx1, tx2), MAX(ty1, ty2)), MAX(tz1, tz2));
+        float t = t_near < 0 ? t_far : t_near;
+        
+        if (t_near <= t_far && t >= 0 && t < lane_t[0]) {
+            lane_t[0] = t;
+            lane_index[0] = i;
+        }
+    }
+#endif
+    
+    for (int lane = 0; lane < lane_count; lane++) {
+        if (lane_index[lane] < 0) { continue; }
         
-        in_quad = (min_x <= intersection.x) && (min_y <= intersection.y) 
-            && (max_x >= intersection.x) && (max_y >= intersection.y);
-    }     
-
-    if (in_quad) { return distance_to_plane; }
-    return -1;
+        if (lane_t[lane] < result.distance || (lane_t[lane] == result.distance && lane_index[lane] < result.index)) {
+            result.distance = lane_t[lane];
+            result.index = lane_index[lane];
+        }
+    }
+    
+    if (result.index >= 0) {
+        // @Note: the face that was hit is the one the hit point is closest to, relative to the box size
+        int i = result.index;
+        vec3 p = vec_add(ray_origin, vec_mul(ray_dir, result.distance));
+        vec3 center = vec3((boxes.min_x[i] + boxes.max_x[i]) * .5f, (boxes.min_y[i] + boxes.max_y[i]) * .5f, (boxes.min_z[i] + boxes.max_z[i]) * .5f);
+        vec3 half = vec3((boxes.max_x[i] - boxes.min_x[i]) * .5f, (boxes.max_y[i] - boxes.min_y[i]) * .5f, (boxes.max_z[i] - boxes.min_z[i]) * .5f);
+        vec3 d = vec3((p.x - center.x) / half.x, (p.y - center.y) / half.y, (p.z - center.z) / half.z);
+        
+        if (ABS(d.x) >= ABS(d.y) && ABS(d.x) >= ABS(d.z)) { result.normal = vec3(d.x < 0 ? -1 : 1, 0, 0); }
+        else if (ABS(d.y) >= ABS(d.z))                    { result.normal = vec3(0, d.y < 0 ? -1 : 1, 0); }
+        else                                              { result.normal = vec3(0, 0, d.z < 0 ? -1 : 1); }
+    }
+    
+    return result;
 }
 
 // === source includes
@@ -263,25 +356,23 @@ static bool editor_controls(game_state* state, key_event event) {
         } break;
         
         case KEY_R: {
-            vec3 axis = vec3(1, 0, 0);
-            float rad = DEG_TO_RAD(90);
+            quat target = ship_orientations[state->current_part_orientation].rotation;
             
-            if (!vec_eq(state->current_part_rotation, state->current_part_rotation_target)) {
-                state->current_part_rotation = state->current_part_rotation_target;
+            if (!vec_eq(state->current_part_rotation, target)) {
+                state->current_part_rotation = target;
             }
             
-            state->current_part_rotation_target = quat_mul_quat(quat_from_axis_angle(axis, rad), state->current_part_rotation);
+            state->current_part_orientation = ship_orientation_products[ship_orientation_turn_x][state->current_part_orientation];
             state->part_rotation_t = 0;
         } break;
         case KEY_T: {
-            vec3 axis = vec3(0, 1, 0);
-            float rad = DEG_TO_RAD(90);
+            quat target = ship_orientations[state->current_part_orientation].rotation;
             
-            if (!vec_eq(state->current_part_rotation, state->current_part_rotation_target)) {
-                state->current_part_rotation = state->current_part_rotation_target;
+            if (!vec_eq(state->current_part_rotation, target)) {
+                state->current_part_rotation = target;
             }
             
-            state->current_part_rotation_target = quat_mul_quat(quat_from_axis_angle(axis, rad), state->current_part_rotation);
+            state->current_part_orientation = ship_orientation_products[ship_orientation_turn_y][state->current_part_orientation];
             state->part_rotation_t = 0;
         } break;
         
@@ -320,12 +411,76 @@ static bool editor_controls(game_state* state, key_event event) {
             ship.pos_t = 0;
         } break;
 
+#if DEV
+        case KEY_F5: {
+            state->snapshot_request = SNAPSHOT_REQUEST_SAVE;
+        } break;
+        case KEY_F9: {
+            state->snapshot_request = SNAPSHOT_REQUEST_LOAD;
+        } break;
+#endif
+
+#if MEMORY_TRACKING
+        case KEY_F3: {
+            toggle(state->show_memory_panel);
+        } break;
+        case KEY_F4: {
+            memory_tracking_write_report(stdout, false);
+            
+            FILE* file = fopen("memory_report.csv", "w");
+            if (!file) {
+                report("Could not open memory_report.csv\n");
+                break;
+            }
+            memory_tracking_write_report(file, true);
+            fclose(file);
+        } break;
+#endif
+
         default: { result = false; } break;
     }
     
     return result;
 }
 
+#if MEMORY_TRACKING
+static void render_memory_panel() {
+    memory_site* sites[16];
+    int count = memory_tracking_get_sorted_sites(sites, array_count(sites));
+    
+    int height = 16;
+    float y = height * 1.1 + height * 6;
+    
+    for (int i = 0; i < count; i++) {
+        memory_site* site = sites[i];
+        
+        string buffer = string_buffer(128);
+        string_write(&buffer, memory_tracking_get_arena_name(site->arena_base));
+        string_write(&buffer, " ");
+        string_write(&buffer, memory_tracking_short_file(site->file));
+        string_write(&buffer, ":");
+        string_write(&buffer, site->line);
+        
+        if (site->type == MEMORY_SITE_PUSH) {
+            string_write(&buffer, "  ");
+            string_write(&buffer, (int)(site->live / 1024));
+            string_write(&buffer, " KB, peak ");
+            string_write(&buffer, (int)(site->peak / 1024));
+            string_write(&buffer, " KB, ");
+        } else {
+            string_write(&buffer, site->type == MEMORY_SITE_SAVE ? "  save, " : "  restore, ");
+        }
+        string_write(&buffer, site->count);
+        string_write(&buffer, "x");
+        
+        float width = get_text_width_single_line(buffer, height);
+        render_text(buffer, global->platform->window_width - width * 1.1, y, .height = height, 
+            .color = RGBA(255, 255, 255, 150));
+        y += height * 1.5;
+    }
+}
+#endif
+
 framebuffer_info icon_fb;
 float scroll_t = 0;
 float scroll_to_add = 0;
@@ -428,7 +583,7 @@ static void update_and_render_part_buttons() {
             global->current_part_type_id = i; 
            
             global->current_part_rotation = (quat) { 0, 0, 0, 1 };
-            global->current_part_rotation_target = (quat) { 0, 0, 0, 1 };
+            global->current_part_orientation = SHIP_ORIENTATION_IDENTITY;
         }
         
         ui_quad_textured(x, y, button_w, button_w, icon_fb.attachments[0].id, .shader = get_shader("part_icon"));
@@ -437,23 +592,52 @@ static void update_and_render_part_buttons() {
     }
 }
 
-static void game_init_memory(platform_info* platform) {
+// @Note: after the editor globals and procs it saves and restores
+#include "snapshot.c"
+#include "hot_reload.c"
+
+GAME_EXPORT void game_init_memory(platform_info* platform) {
     assert(platform->permanent_storage);
     assert(sizeof(game_state) < platform->permanent_storage_size);
     
-    game_state* state = platform->permanent_storage;
+    load_module_imports(platform);
+    memory_tracking_track_this_thread();
+    
+    // @Info: the game state is the first thing in the permanent arena, that commits its pages
+    memory_arena permanent_arena;
+    init_reserved_arena(&permanent_arena, platform->permanent_storage_size, platform->permanent_storage);
+    
+    game_state* state = push_struct(&permanent_arena, game_state);
     
     global = state;
     global->platform = platform;
     
+    state->layout_hash = get_game_layout_hash();
     state->time.simulation_speed = 1.0;
     
-    init_arena(&state->permanent_arena, 
-        platform->permanent_storage_size - sizeof(game_state), 
-        (u8*)platform->permanent_storage + sizeof(game_state));
-    init_arena(&state->transient_arena,
-        platform->transient_storage_size,
-        (u8*)platform->transient_storage);
+    state->permanent_arena = permanent_arena;
+    
+    { // @Info: the transient storage holds the per frame arena and the two double buffered ones, each followed by a guard
+        u64 double_buffered_size = platform->transient_storage_size / 4;
+        u64 transient_size = platform->transient_storage_size - 2 * (double_buffered_size + MEMORY_GUARD_SIZE);
+        
+        u8* base = platform->transient_storage;
+        init_reserved_arena(&state->transient_arena, transient_size, base);
+        base += transient_size + MEMORY_GUARD_SIZE;
+        
+        for (int i = 0; i < array_count(state->double_buffered_arenas); i++) {
+            init_reserved_arena(&state->double_buffered_arenas[i], double_buffered_size, base);
+            base += double_buffered_size + MEMORY_GUARD_SIZE;
+        }
+    }
+    
+#if MEMORY_TRACKING
+    state->memory_tracker = push_struct(&state->permanent_arena, memory_tracker);
+    memory_tracking_move_to(state->memory_tracker);
+#endif
+    track_game_arenas(state);
+    
+    state->strings = make_string_intern_pool(push_permanent, 64);
     
     load_all_shaders(state, "../source/shaders/");
     load_all_textures(state, "../data/textures/");
@@ -464,10 +648,14 @@ static void game_init_memory(platform_info* platform) {
     state->current_camera = &state->editor_camera;
     
     init_renderer(state);
+    camera_update_constants(&state->renderer.camera, state->current_camera, 
+                            state->platform->window_width, state->platform->window_height);
 
+    init_ship_orientations();
     init_ship_part_types(state);
     init_ship_save_slots(state);
     
+    part_graph = make_ship_graph(&state->permanent_arena, SHIP_PART_MAX_COUNT);
     load_ship(state, &ship);
 
     init_framebuffer(&icon_fb);
@@ -475,33 +663,46 @@ static void game_init_memory(platform_info* platform) {
     framebuffer_add_attachment(&icon_fb, GL_DEPTH_ATTACHMENT, 100, 100);
     
     state->current_part_rotation = (quat) { 0, 0, 0, 1 };
-    state->current_part_rotation_target = (quat) { 0, 0, 0, 1 };
+    state->current_part_orientation = SHIP_ORIENTATION_IDENTITY;
     
     bind_key_input_proc(editor_controls);
     
 }
 
-static void game_update_and_render(platform_info* platform) {
+// @Info: clears the transient arena and the older of the double buffered ones, 
+//        after taking down how much of them the last frame used
+static void begin_frame_memory(game_state* state) {
+    memory_arena* transient = &state->transient_arena;
+    memory_arena* double_buffered = &state->double_buffered_arenas[state->double_buffered_index];
+    
+    frame_memory_stats* stats = &state->memory_stats;
+    stats->frame_peak = transient->high_water + double_buffered->high_water;
+    stats->session_peak = MAX(stats->session_peak, stats->frame_peak);
+    
+    clear_arena(transient);
+    
+    state->double_buffered_index = !state->double_buffered_index;
+    clear_arena(&state->double_buffered_arenas[state->double_buffered_index]);
+}
+
+GAME_EXPORT void game_update_and_render(platform_info* platform) {
     game_state* state = platform->permanent_storage;
     
-    update_time_info(&state->time, platform->dt_ms);
+    begin_frame_memory(state);
+    handle_snapshot_request(state);
+    finish_ship_save_thumbnail(state, &ship);
+    
+    update_time_info(&state->time, platform->dt_ticks, platform->ticks_per_second);
     process_input(state);
     
     ui_frame_begin(state);
     
     update_editor_camera(state);
-    
+    camera_update_constants(&state->renderer.camera, state->current_camera, 
+                            state->platform->window_width, state->platform->window_height);
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    state->renderer.projection_matrix = make_projection_matrix(
-        state->platform->window_width,  
-        state->platform->window_height,
-        state->current_camera->fov,
-        state->current_camera->near,
-        state->current_camera->far
-    );
-
     // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     
     { // === render into scene texture
@@ -581,9 +782,42 @@ static void game_update_and_render(platform_info* platform) {
         render_text(buffer, platform->window_width - width * 1.1, height * 1.1 + height * 1.5, .height = height, 
             .color = RGBA(255, 255, 255, 150));
     }
+    
+    {
+        string buffer = string_buffer(64);
+        string_write(&buffer, "frame memory: ");
+        string_write(&buffer, (int)(state->memory_stats.frame_peak / 1024));
+        string_write(&buffer, " KB, peak ");
+        string_write(&buffer, (int)(state->memory_stats.session_peak / 1024));
+        string_write(&buffer, " KB");
+        int height = 16;
+        float width = get_text_width_single_line(buffer, height);
+        render_text(buffer, platform->window_width - width * 1.1, height * 1.1 + height * 3, .height = height, 
+            .color = RGBA(255, 255, 255, 150));
+    }
+    
+    {
+        frame_time_stats* stats = &platform->frame_times;
+        
+        string buffer = string_buffer(64);
+        string_write(&buffer, "frame ms p50 ");
+        string_write(&buffer, stats->p50, .prec = 2);
+        string_write(&buffer, " p95 ");
+        string_write(&buffer, stats->p95, .prec = 2);
+        string_write(&buffer, " p99 ");
+        string_write(&buffer, stats->p99, .prec = 2);
+        int height = 16;
+        float width = get_text_width_single_line(buffer, height);
+        render_text(buffer, platform->window_width - width * 1.1, height * 1.1 + height * 4.5, .height = height, 
+            .color = RGBA(255, 255, 255, 150));
+    }
+    
+#if MEMORY_TRACKING
+    if (state->show_memory_panel) { render_memory_panel(); }
+#endif
 }
 
-static void game_resize_window(platform_info* platform) {
+GAME_EXPORT void game_resize_window(platform_info* platform) {
     game_state* state = platform->permanent_storage;
     
     glViewport(0, 0, platform->window_width, platform->window_height);
@@ -23,9 +23,26 @@ typedef u8 bool;
 #define true 1
 
 #define toggle(b) ((b) = !(b)) 
+
+#if defined(_MSC_VER)
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL _Thread_local
+#endif
+
+// @Info: for a value one thread publishes and another one picks up, everything written before the store is
+//        visible after the load that sees it
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    static inline u32 load_acquire(volatile u32* p)            { u32 result = *p; _ReadWriteBarrier(); return result; }
+    static inline void store_release(volatile u32* p, u32 value) { _ReadWriteBarrier(); *p = value; }
+#else
+    static inline u32 load_acquire(volatile u32* p)            { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+    static inline void store_release(volatile u32* p, u32 value) { __atomic_store_n(p, value, __ATOMIC_RELEASE); }
+#endif
 #define stringify(x) #x
 
-#define array_count(a) (sizeof(a) / sizeof(a[0]))
+#define array_count(a) ((int)(sizeof(a) / sizeof(a[0])))
 
 #define kilobytes(n) ((n) * 1024ull)
 #define megabytes(n) (kilobytes(n) * 1024ull)
@@ -63,7 +80,9 @@ typedef u8 bool;
                                                 
 // === external includes                                 
 #include "extern/glad.c"
-#include "extern/wglext.h"
+#ifdef _WIN32
+    #include "extern/wglext.h"
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_ASSERT(X) assert(X)
@@ -118,21 +137,75 @@ typedef struct {
     };
 } event_info;
 
+// @Info: uncommitted gap the platform leaves after each arena, touching it faults. Define it as 0 to pack them.
+#ifndef MEMORY_GUARD_SIZE
+    #define MEMORY_GUARD_SIZE kilobytes(64)
+#endif
+
+// @Info: per call site arena statistics, F3 shows them on the overlay and F4 writes memory_report.csv
+#ifndef MEMORY_TRACKING
+    #define MEMORY_TRACKING DEV
+#endif
+
+#define ARENA_COMMIT_SIZE kilobytes(64) // @Info: reserved arenas commit in steps of this
+#define SCRATCH_ARENA_SIZE gigabytes(1)  // @Info: reserved for each of the two scratch arenas of every thread
+
 typedef struct {
     void* base;
     u64 size;
     u64 used;
-
-    u64 _saved[8];
-    u32 _saved_count;
+    u64 committed;
+    u64 high_water; // @Info: highest used since the last clear
 } memory_arena;
 
+// @Info: from save_arena, restore_arena frees everything pushed after it. They live wherever the caller keeps 
+//        them, so saves nest as deep as needed.
+typedef struct {
+    memory_arena* arena;
+    u64 used;
+} arena_marker;
+
+// @Info: poisons pool elements and catches double frees
+#ifndef MEMORY_POOL_DEBUG
+    #define MEMORY_POOL_DEBUG DEV
+#endif
+
+// @Info: fixed size elements carved out of an arena, see init_pool
+typedef struct {
+    memory_arena* arena;
+    u32 element_size;
+    u32 alignment;
+    u32 block_count;        // elements pushed at once when the pool runs out
+    
+    void* free_list;
+    u8* block_cursor;       // rest of the last block, handed out before it is threaded onto the free list
+    u32 block_remaining;
+    
+    u32 used_count;
+    u32 capacity;
+} memory_pool;
+
+// @Info: in milliseconds, from one frame start to the next
+typedef struct {
+    float p50, p95, p99;
+    float worst;
+    u32 sample_count;
+} frame_time_stats;
+
+typedef struct {
+    u64 frame_peak;     // @Info: what the last frame pushed into the transient and double buffered arenas at most
+    u64 session_peak;
+} frame_memory_stats;
+
 typedef struct {
     float dt;
     float dt_ms;
-    float in_seconds;
+    float in_seconds;       // @Info: both from ticks, so they do not drift like a float that gets added up would
     float in_milliseconds;
     
+    u64 ticks;              // @Info: simulated time so far
+    u64 ticks_per_second;
+    
     float simulation_speed;
     
     float realtime_dt;
@@ -155,7 +228,6 @@ typedef struct {
     vec3 up;
     vec3 right;
     
-    mat4 view_matrix;
     float near, far;
     float fov;
     
@@ -174,6 +246,7 @@ typedef struct {
 
 #define MAX_EVENT_COUNT 128
 typedef struct {
+    // @Info: only reserved, the arenas on top commit pages as they grow
     u64 permanent_storage_size;
     void* permanent_storage;
     
@@ -183,15 +256,58 @@ typedef struct {
     event_info events[MAX_EVENT_COUNT];
     int event_count;
     
+    // @Info: from platform_get_ticks, see frame_timing.c
+    u64 ticks_per_second;
+    u64 current_ticks;
+    u64 dt_ticks;
     double dt_ms;
-    u32 current_time;
+    
+    u32 target_frame_rate;          // @Info: 0 does not limit it, the game may change it at any time
+    frame_time_stats frame_times;   // @Info: over the last few hundred frames
     
     int window_width;
     int window_height;
     
     bool is_running;
+    
+    platform_api api;                                   // @Info: for a game module, see platform.h
+    void* (*gl_get_proc_address)(const char* name);     // @Info: a game module loads its own GL functions with this
 } platform_info;
 
+static inline void add_event(platform_info* platform, event_info e) {
+    if (platform->event_count + 1 > MAX_EVENT_COUNT) {
+        report("Event buffer is full\n");
+    } else {
+        platform->events[platform->event_count++] = e;
+    }
+}
+
+// @Info: what the platform calls in the game. A game module exports them, see game_module.c.
+#if !GAME_MODULE
+    #define GAME_EXPORT static
+#elif defined(_WIN32)
+    #define GAME_EXPORT __declspec(dllexport)
+#else
+    #define GAME_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef void game_init_memory_proc(platform_info* platform);
+typedef void game_update_and_render_proc(platform_info* platform);
+typedef void game_resize_window_proc(platform_info* platform);
+typedef bool game_load_last_snapshot_proc(platform_info* platform);
+typedef void game_unload_proc(platform_info* platform);
+typedef void game_reload_proc(platform_info* platform);
+
+// @Info: how the platform reaches the game. unload and reload are only there for a game module.
+typedef struct {
+    game_init_memory_proc*        init_memory;
+    game_update_and_render_proc*  update_and_render;
+    game_resize_window_proc*      resize_window;
+    game_load_last_snapshot_proc* load_last_snapshot;
+    game_unload_proc*             unload;
+    game_reload_proc*             reload;
+} game_code;
+
 typedef struct {
     union {
         struct { float x, y; };
@@ -208,6 +324,12 @@ typedef struct {
 
 typedef struct game_state game_state;
 
+enum {
+    SNAPSHOT_REQUEST_NONE,
+    SNAPSHOT_REQUEST_SAVE,
+    SNAPSHOT_REQUEST_LOAD,
+};
+
 // === header includes
 #include "keycodes.h"
 #include "render.h"
@@ -215,18 +337,75 @@ typedef struct game_state game_state;
 #include "ui.h"
 #include "ships.h"
 
+#define TEXT_LAYOUT_CACHE_SIZE    64
+#define TEXT_LAYOUT_CACHE_BUCKETS 128   // power of two
+#define TEXT_LAYOUT_MAX_LENGTH    64    // longer text is not cached and gets laid out every time
+
+typedef struct {
+    vec2 p;     // pixels relative to where the text starts, y down
+    vec2 uv;
+} glyph_vertex;
+
+typedef struct {
+    int glyph_count;    // 6 vertices each
+    ivec2 dimensions;
+    vec2 end;           // where the text stops, relative to where it starts
+} text_layout_info;
+
+typedef struct {
+    u32 hash;
+    int height;
+    u32 break_after_width;
+    u32 clamp_after_width;
+    u32 clamp_after_height;
+
+    int text_length;
+    char text[TEXT_LAYOUT_MAX_LENGTH];
+
+    text_layout_info info;
+    glyph_vertex vertices[TEXT_LAYOUT_MAX_LENGTH * 6];
+
+    s16 bucket_next;            // -1 ends the chain
+    s16 lru_prev, lru_next;     // -1 ends the list
+} text_layout;
+
+// @Info: fixed pool of laid out text, the least recently used one gets replaced when it is full
+typedef struct {
+    text_layout entries[TEXT_LAYOUT_CACHE_SIZE];
+    int count;
+
+    s16 buckets[TEXT_LAYOUT_CACHE_BUCKETS];
+    s16 lru_first, lru_last;    // first is the most recently used
+} text_layout_cache;
+
 typedef struct {
     texture_info* texture;
     float x_advance;
     float glyph_width, glyph_height;
     u32 glyph_count;
+
+    text_layout_cache* layouts; // @Info: in the permanent arena
+    u32 vao, vbo;
 } font_info;
 
 typedef struct game_state {
+    u64 layout_hash;        // @Info: first, so a reloaded game module can tell whether the layout still fits
+    void* module_globals;   // @Info: where the game module keeps its globals while it gets reloaded
+    
     platform_info* platform;
     
     memory_arena permanent_arena;
-    memory_arena transient_arena;
+    memory_arena transient_arena;               // @Info: cleared at the start of every frame
+    memory_arena double_buffered_arenas[2];     // @Info: see push_double_buffered
+    u32 double_buffered_index;
+    frame_memory_stats memory_stats;
+#if MEMORY_TRACKING
+    bool show_memory_panel;
+    struct memory_tracker* memory_tracker;  // @Info: in the permanent arena, so it outlives a reload of the game module
+#endif
+    u8 snapshot_request;    // @Info: handled at the start of the next frame, see snapshot.c
+    
+    string_intern_pool strings; // @Info: backed by the permanent arena
 
     camera_info editor_camera;
     camera_info* current_camera;
@@ -247,8 +426,8 @@ typedef struct game_state {
     text_input* current_text_input;
     key_input_proc* current_input_proc;
     
-    quat current_part_rotation;
-    quat current_part_rotation_target;
+    quat current_part_rotation; // @Info: animated towards current_part_orientation
+    ship_orientation current_part_orientation;
     float part_rotation_t;
     
     int current_part_type_id;
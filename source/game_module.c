@@ -0,0 +1,13 @@
+// @Info: the game on its own, as game.dll or game.so. The platform layer loads it instead of building the game
+//        into itself when GAME_HOT_RELOAD is set (DEV builds), and reloads it whenever it gets rebuilt. It reaches
+//        the platform through platform_info.api, see platform.h and hot_reload.c.
+#define GAME_MODULE 1
+
+#include <stdio.h>
+
+#include "vector.c"
+#include "string.c"
+
+#include "platform.h"
+
+#include "game.c"
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stddef.h>
+
+// @Info: A game module (see game_module.c) keeps its state in the permanent storage of the platform, which stays
+//        where it is when the platform reloads the module. What goes away with the old module are its globals,
+//        its GL function pointers and everything that points into its code. game_unload copies the globals into
+//        the permanent storage before the platform unloads the module, game_reload in the new one copies them
+//        back and fixes up the rest the same way loading a snapshot does.
+//
+//        GL objects belong to the context of the platform, they all stay valid. If the new module changed the
+//        layout of game_state or the size of the globals the old state does not fit anymore, so it starts over.
+
+// @Info: globals the snapshots leave out because they belong to the session, on top of snapshot_globals.
+//        The ship orientation tables are not here, they are just made again.
+static struct {
+    void* data;
+    u64 size;
+} session_globals[] = {
+    SNAPSHOT_GLOBAL(icon_fb),
+    SNAPSHOT_GLOBAL(part_types),
+    SNAPSHOT_GLOBAL(debug_index_count),
+};
+
+static u64 get_module_globals_size() {
+    u64 result = get_snapshot_globals_size();
+    for (int i = 0; i < array_count(session_globals); i++) { result += session_globals[i].size; }
+    return result;
+}
+
+// @Info: bump it for layout changes get_game_layout_hash does not see, like two fields of the same size trading places
+//        or a new type that gets pushed onto the permanent arena without being added to the hash
+#define GAME_LAYOUT_VERSION 1
+
+// @Info: the version, the size of game_state and where its parts are, the size of every other type that lives in the
+//        permanent arena with the offsets the game reads it by, and the size of every global. The sizes alone miss a
+//        field that moved, with everything after it still adding up to the same size.
+static u64 get_game_layout_hash() {
+    u64 values[] = {
+        GAME_LAYOUT_VERSION,
+        
+        // @Note: the catalogs are arrays, a different size changes the stride
+        sizeof(shader_info),
+        offsetof(shader_info, path),
+        offsetof(shader_info, id),
+        sizeof(texture_info),
+        offsetof(texture_info, path),
+        offsetof(texture_info, id),
+        offsetof(texture_info, w),
+        
+        sizeof(text_layout_cache),
+        sizeof(text_layout),
+        offsetof(text_layout, text),
+        offsetof(text_layout, vertices),
+        offsetof(text_layout, bucket_next),
+        offsetof(text_layout_cache, count),
+        offsetof(text_layout_cache, buckets),
+        
+        sizeof(string_intern_entry),
+        offsetof(string_intern_entry, hash),
+        sizeof(string_id),
+        
+        sizeof(ship_graph_neighbors),
+        
+#if MEMORY_TRACKING
+        sizeof(memory_tracker),
+        sizeof(memory_site),
+        sizeof(memory_arena_log),
+        offsetof(memory_tracker, arenas),
+        offsetof(memory_tracker, names),
+#endif
+        
+        sizeof(game_state),
+        offsetof(game_state, module_globals),
+        offsetof(game_state, permanent_arena),
+        offsetof(game_state, transient_arena),
+        offsetof(game_state, memory_stats),
+        offsetof(game_state, strings),
+        offsetof(game_state, editor_camera),
+        offsetof(game_state, mouse),
+        offsetof(game_state, time),
+        offsetof(game_state, ui),
+        offsetof(game_state, renderer),
+        offsetof(game_state, shaders),
+        offsetof(game_state, textures),
+        offsetof(game_state, font),
+        offsetof(game_state, current_input_proc),
+        offsetof(game_state, current_part_rotation),
+        offsetof(game_state, current_part_type_id),
+        offsetof(game_state, saves),
+    };
+    u64 global_sizes[array_count(snapshot_globals) + array_count(session_globals)];
+    
+    int count = 0;
+    for (int i = 0; i < array_count(snapshot_globals); i++) { global_sizes[count++] = snapshot_globals[i].size; }
+    for (int i = 0; i < array_count(session_globals); i++)  { global_sizes[count++] = session_globals[i].size; }
+    
+    u64 result = string_hash(string((char*)values, sizeof(values)));
+    return (result << 32) | string_hash(string((char*)global_sizes, sizeof(global_sizes)));
+}
+
+// @Info: into state->module_globals if to_storage is set, back out of it otherwise
+static void copy_module_globals(game_state* state, bool to_storage) {
+    char* at = state->module_globals;
+    
+    for (int i = 0; i < array_count(snapshot_globals); i++) {
+        if (to_storage) { memory_copy(at, snapshot_globals[i].data, snapshot_globals[i].size); }
+        else            { memory_copy(snapshot_globals[i].data, at, snapshot_globals[i].size); }
+        at += snapshot_globals[i].size;
+    }
+    
+    for (int i = 0; i < array_count(session_globals); i++) {
+        if (to_storage) { memory_copy(at, session_globals[i].data, session_globals[i].size); }
+        else            { memory_copy(session_globals[i].data, at, session_globals[i].size); }
+        at += session_globals[i].size;
+    }
+}
+
+// @Info: a game module has its own copy of these, they are empty every time it gets loaded
+static void load_module_imports(platform_info* platform) {
+#if GAME_MODULE
+    load_platform_api(&platform->api);
+    gladLoadGLLoader((GLADloadproc)platform->gl_get_proc_address);
+#endif
+}
+
+static void track_game_arenas(game_state* state) {
+    memory_tracking_track_this_thread();
+    
+    memory_tracking_name_arena(&state->permanent_arena, "permanent");
+    memory_tracking_name_arena(&state->transient_arena, "transient");
+    memory_tracking_name_arena(&state->double_buffered_arenas[0], "double_0");
+    memory_tracking_name_arena(&state->double_buffered_arenas[1], "double_1");
+}
+
+// @Info: the old module, right before the platform unloads it
+GAME_EXPORT void game_unload(platform_info* platform) {
+    game_state* state = platform->permanent_storage;
+    
+    if (!state->module_globals) { state->module_globals = push_size(&state->permanent_arena, get_module_globals_size()); }
+    copy_module_globals(state, true);
+    
+    // @Note: the callbacks are in this module, the thread local scratch arenas go away with it
+    platform_clear_file_watches();
+    release_scratch_arenas();
+    memory_tracking_keep_names();
+}
+
+GAME_EXPORT void game_init_memory(platform_info* platform);
+
+// @Info: the new module, right after the platform loaded it
+GAME_EXPORT void game_reload(platform_info* platform) {
+    load_module_imports(platform);
+    
+    game_state* state = platform->permanent_storage;
+    if (state->layout_hash != get_game_layout_hash()) {
+        report("The game state changed its layout, starting over\n");
+        
+        // @Note: GL objects of the old state are leaked, nothing knows their ids anymore
+        platform_decommit_memory(platform->permanent_storage, platform->permanent_storage_size);
+        game_init_memory(platform);
+        return;
+    }
+    
+    global = state;
+#if MEMORY_TRACKING
+    memory_tracking_use(state->memory_tracker);
+#endif
+    track_game_arenas(state);
+    memory_tracking_replace_arena(&state->permanent_arena);
+    memory_tracking_replace_arena(&state->double_buffered_arenas[0]);
+    memory_tracking_replace_arena(&state->double_buffered_arenas[1]);
+    
+    copy_module_globals(state, false);
+    init_ship_orientations();
+    
+    fix_up_process_state(state);
+    
+    report("Reloaded the game code\n");
+}
@@ -202,7 +202,7 @@ static inline void text_input_move_cursor_left(text_input* input) {
 }
 
 void text_input_delete_at_index(text_input* input, int pos, int count) {
-    for (int i = pos; i < input->buffer.length; i++) {
+    for (int i = pos; i < (int)input->buffer.length; i++) {
         input->buffer.data[i - count] = input->buffer.data[i];
     }
 
@@ -7,7 +7,7 @@ typedef KEY_INPUT_PROC(key_input_proc);
 
 typedef struct {
     string buffer;
-    u8* cursor;
+    char* cursor;
 } text_input;
 
 void keymap_set(game_state* state, u32 key, bool on);
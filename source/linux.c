@@ -0,0 +1,725 @@
+#define _GNU_SOURCE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "vector.c"
+#include "string.c"
+
+#include "platform.h"
+
+// @Info: runs the game without a window, either rendering offscreen through EGL (Mesa llvmpipe does fine) or,
+//        with -headless, with every GL call going nowhere. See main for the arguments.
+
+// @Note: not static like in win32.c, gcc and clang do not accept a static definition after the extern
+//        declaration in platform.h
+
+#define linux_handle_failed_assertion platform_handle_failed_assertion
+#define linux_add_file_watch          platform_add_file_watch
+#define linux_clear_file_watches      platform_clear_file_watches
+#define linux_find_all_files          platform_find_all_files
+#define linux_sleep                   platform_sleep
+#define linux_get_ticks               platform_get_ticks
+#define linux_get_tick_frequency      platform_get_tick_frequency
+#define linux_map_file                platform_map_file
+#define linux_unmap_file              platform_unmap_file
+#define linux_get_page_size           platform_get_page_size
+#define linux_reserve_memory          platform_reserve_memory
+#define linux_commit_memory           platform_commit_memory
+#define linux_decommit_memory         platform_decommit_memory
+#define linux_release_memory          platform_release_memory
+#define linux_map_file_into_reserved  platform_map_file_into_reserved
+
+#include "game.h"
+
+// @Info: DEV builds load the game from game.so (see game_module.c) and reload it whenever it gets rebuilt
+#ifndef GAME_HOT_RELOAD
+    #define GAME_HOT_RELOAD DEV
+#endif
+
+#if GAME_HOT_RELOAD
+    #include <dlfcn.h>
+#else
+#include "game.c"
+#endif
+
+#include "file_watch.c"
+#include "frame_timing.c"
+
+#if DEV
+    int inotify_handle = -1;
+    int directory_descriptors[MAX_WATCHED_DIRECTORY_COUNT]; // @Info: by watched directory index
+#endif
+
+typedef struct {
+    void* memory;
+    u64 size;
+} linux_mapped_file;
+
+// @Info: munmap wants the size back that platform_unmap_file does not get
+#define MAX_MAPPED_FILE_COUNT 64
+linux_mapped_file mapped_files[MAX_MAPPED_FILE_COUNT];
+
+void linux_handle_failed_assertion(char* expr_str, char* file, int line) {
+    report("Assertion at %s:%d failed!\n\t%s\n", file, line, expr_str);
+    fflush(stdout);
+    __builtin_trap();
+}
+
+void linux_sleep(u64 time) {
+    struct timespec duration = { .tv_sec = time / 1000, .tv_nsec = (time % 1000) * 1000000 };
+    while (nanosleep(&duration, &duration) == -1 && errno == EINTR) {}
+}
+
+// @Info: nanoseconds
+u64 linux_get_ticks() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+u64 linux_get_tick_frequency() {
+    return 1000000000ull;
+}
+
+// @Note: format is a shell pattern like "*.glsl", names come in alphabetical order like they do on NTFS
+int linux_find_all_files(char* dir, char* format, void* memory, u64 capacity, u64* bytes_used) {
+    struct dirent** entries;
+    int entry_count = scandir(dir, &entries, 0, alphasort);
+    if (entry_count < 0) { return 0; }
+    
+    u8* dest = memory;
+    bool full = false;
+    
+    int i = 0;
+    for (int j = 0; j < entry_count; j++) {
+        char* name = entries[j]->d_name;
+        
+        if (!full && name[0] != '.' && fnmatch(format, name, 0) == 0) {
+            int len = strlen(name);
+            
+            if (dest + len + 1 > (u8*)memory + capacity) {
+                report("Not all files in %s fit into %llu bytes\n", dir, capacity);
+                full = true;
+            } else {
+                strcpy((char*)dest, name);
+                dest += len + 1;
+                i++;
+            }
+        }
+        
+        free(entries[j]);
+    }
+    
+    free(entries);
+    
+    if (bytes_used) { *bytes_used = dest - (u8*)memory; }
+    
+    return i;
+}
+
+// @Info: same as win32_map_file, at most size bytes from the start of the file read-only
+void* linux_map_file(char* path, u64 size, u64* mapped_size) {
+    *mapped_size = 0;
+    
+    int file = open(path, O_RDONLY);
+    if (file < 0) { return 0; }
+    
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return 0;
+    }
+    
+    u64 to_map = MIN(size, (u64)info.st_size);
+    
+    // @Note: the mapping keeps the file open on its own
+    void* result = mmap(0, to_map, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    
+    if (result == MAP_FAILED) { return 0; }
+    
+    for (int i = 0; i < MAX_MAPPED_FILE_COUNT; i++) {
+        if (!mapped_files[i].memory) {
+            mapped_files[i] = (linux_mapped_file){ result, to_map };
+            *mapped_size = to_map;
+            return result;
+        }
+    }
+    
+    report("Too many mapped files, could not map %s\n", path);
+    munmap(result, to_map);
+    return 0;
+}
+
+void linux_unmap_file(void* memory) {
+    if (!memory) { return; }
+    
+    for (int i = 0; i < MAX_MAPPED_FILE_COUNT; i++) {
+        if (mapped_files[i].memory == memory) {
+            munmap(memory, mapped_files[i].size);
+            mapped_files[i] = (linux_mapped_file){ 0 };
+            return;
+        }
+    }
+}
+
+unsigned long long linux_get_page_size() {
+    return (unsigned long long)sysconf(_SC_PAGESIZE);
+}
+
+// @Note: base is only a hint, mmap picks another address if that range is taken (VirtualAlloc fails instead)
+void* linux_reserve_memory(void* base, unsigned long long size) {
+    void* result = mmap(base, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return (result == MAP_FAILED) ? 0 : result;
+}
+
+bool linux_commit_memory(void* memory, unsigned long long size) {
+    return mprotect(memory, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+// @Note: MADV_DONTNEED drops the pages, they are zero again when they get committed the next time
+void linux_decommit_memory(void* memory, unsigned long long size) {
+    madvise(memory, size, MADV_DONTNEED);
+    mprotect(memory, size, PROT_NONE);
+}
+
+void linux_release_memory(void* memory, unsigned long long size) {
+    munmap(memory, size);
+}
+
+// @Note: MAP_FIXED replaces what was there, a failed MAP_FIXED may have dropped it already though
+bool linux_map_file_into_reserved(char* path, unsigned long long offset, unsigned long long size,
+                                  void* base, unsigned long long region_size) {
+    int file = open(path, O_RDONLY);
+    if (file < 0) { return false; }
+    
+    void* view = mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file, offset);
+    close(file);
+    
+    int reserve_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED;
+    if (view == MAP_FAILED) {
+        mmap(base, region_size, PROT_NONE, reserve_flags, -1, 0);
+        return false;
+    }
+    
+    if (size < region_size) { mmap((char*)base + size, region_size - size, PROT_NONE, reserve_flags, -1, 0); }
+    return true;
+}
+
+#if DEV
+static void* linux_file_watcher_thread(void* unused) {
+    _Alignas(struct inotify_event) char buffer[4096];
+    u64 wait = (u64)-1;
+    
+    while (true) {
+        struct pollfd poll_info = { .fd = inotify_handle, .events = POLLIN };
+        
+        if (poll(&poll_info, 1, (wait == (u64)-1) ? -1 : (int)wait) > 0) {
+            ssize_t length = read(inotify_handle, buffer, sizeof(buffer));
+            u64 now = linux_get_ticks() / 1000000;
+            
+            for (char* at = buffer; length > 0 && at < buffer + length; ) {
+                struct inotify_event* event = (struct inotify_event*)at;
+                at += sizeof(struct inotify_event) + event->len;
+                
+                if (!event->len) { continue; }
+                
+                u32 directory_count = load_acquire(&watched_directory_count);
+                for (u32 i = 0; i < directory_count; i++) {
+                    if (directory_descriptors[i] == event->wd) { file_watch_note_change(i, event->name, strlen(event->name), now); }
+                }
+            }
+        }
+        
+        wait = file_watch_flush_pending(linux_get_ticks() / 1000000);
+    }
+    
+    return 0;
+}
+
+// @Note: watches the directory and not the file itself, editors that save by renaming a new file over the old
+//        one would leave a watch on the file behind on the deleted inode. Changes that come in before the 
+//        directory is published are lost, that is a window of microseconds right after the first watch in it.
+static int linux_watch_directory(string directory) {
+    if (inotify_handle < 0) {
+        inotify_handle = inotify_init1(IN_CLOEXEC);
+        if (inotify_handle < 0) {
+            report("Could not start watching files: %s\n", strerror(errno));
+            return -1;
+        }
+        
+        pthread_t thread;
+        if (pthread_create(&thread, 0, linux_file_watcher_thread, 0) != 0) {
+            report("Could not start the file watcher thread\n");
+            close(inotify_handle);
+            inotify_handle = -1;
+            return -1;
+        }
+        pthread_detach(thread);
+    }
+    
+    assert(watched_directory_count < MAX_WATCHED_DIRECTORY_COUNT);
+    
+    char path[256];
+    assert(directory.length < sizeof(path) - 1);
+    memory_copy(path, directory.data, directory.length);
+    path[directory.length] = 0;
+    
+    int descriptor = inotify_add_watch(inotify_handle, directory.length ? path : ".", IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0) {
+        report("Could not watch %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    
+    directory_descriptors[watched_directory_count] = descriptor;
+    return file_watch_publish_directory(directory);
+}
+#endif
+
+void linux_add_file_watch(string path, void (*callback)(string, void*), void* data) {
+#if DEV
+    string directory, name;
+    file_watch_split_path(path, &directory, &name);
+    
+    int index = file_watch_find_directory(directory);
+    if (index < 0) { index = linux_watch_directory(directory); }
+    if (index < 0) { return; }
+    
+    file_watch_add(index, path, name, callback, data);
+#endif
+}
+
+void linux_clear_file_watches() {
+    file_watch_clear();
+}
+
+// === headless GL
+//
+// @Info: every GL function resolves to one of these, so the game runs its frames without anything being
+//        rendered. Objects get made up names and status queries succeed, so nothing takes the error paths.
+//        Functions that return a pointer get a real one, strings are empty unless the version is asked for.
+
+// @Note: every mapped buffer is the start of this one reservation, which only takes up memory where something
+//        gets written. Nothing reads mapped memory back here, so it does not matter that they overlap.
+#define HEADLESS_GL_MAPPED_SIZE gigabytes(1)
+
+static u32 headless_gl_name_count;
+static void* headless_gl_mapped;
+
+static u64 headless_gl_nothing() {
+    return 0;
+}
+
+static u64 headless_gl_true() {
+    return GL_TRUE;
+}
+
+static const u8* headless_gl_get_string(u32 name) {
+    if (name == GL_VERSION)                  { return (const u8*)"4.6 headless"; }
+    if (name == GL_SHADING_LANGUAGE_VERSION) { return (const u8*)"4.60 headless"; }
+    return (const u8*)"";
+}
+
+static const u8* headless_gl_get_string_i(u32 name, u32 index) {
+    return (const u8*)"";
+}
+
+static void* headless_gl_map_buffer() {
+    if (!headless_gl_mapped) {
+        headless_gl_mapped = mmap(0, HEADLESS_GL_MAPPED_SIZE, PROT_READ | PROT_WRITE, 
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (headless_gl_mapped == MAP_FAILED) {
+            report("Could not reserve memory for mapped GL buffers\n");
+            exit(1);
+        }
+    }
+    
+    return headless_gl_mapped;
+}
+
+static void headless_gl_get_buffer_pointer(u32 target, u32 name, void** result) {
+    *result = headless_gl_map_buffer();
+}
+
+static void headless_gl_get_pointer(u32 name, void** result) {
+    *result = 0;
+}
+
+// @Note: a sync object only has to be something that is not 0, waiting on it is over right away
+static void* headless_gl_fence_sync(u32 condition, u32 flags) {
+    return (void*)(u64)++headless_gl_name_count;
+}
+
+static u32 headless_gl_client_wait_sync() {
+    return GL_ALREADY_SIGNALED;
+}
+
+static void headless_gl_get_integer(u32 name, int* result) {
+    *result = (name == GL_NUM_EXTENSIONS) ? 0 : 1;
+}
+
+static void headless_gl_get_object_integer(u32 object, u32 name, int* result) {
+    *result = 1;
+}
+
+static void headless_gl_gen_names(int count, u32* names) {
+    for (int i = 0; i < count; i++) { names[i] = ++headless_gl_name_count; }
+}
+
+static u32 headless_gl_create_name() {
+    return ++headless_gl_name_count;
+}
+
+static u32 headless_gl_check_framebuffer_status(u32 target) {
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void* headless_gl_get_proc_address(const char* name) {
+    if (!strcmp(name, "glGetString"))  { return headless_gl_get_string; }
+    if (!strcmp(name, "glGetStringi")) { return headless_gl_get_string_i; }
+    if (!strcmp(name, "glGetIntegerv")) { return headless_gl_get_integer; }
+    if (!strcmp(name, "glGetShaderiv") || !strcmp(name, "glGetProgramiv")) { return headless_gl_get_object_integer; }
+    if (!strcmp(name, "glCreateShader") || !strcmp(name, "glCreateProgram")) { return headless_gl_create_name; }
+    if (!strcmp(name, "glCheckFramebufferStatus")) { return headless_gl_check_framebuffer_status; }
+    
+    // @Note: glMapBuffer, glMapBufferRange, glMapNamedBuffer and glMapNamedBufferRange
+    if (!strncmp(name, "glMap", 5) && strstr(name, "Buffer")) { return headless_gl_map_buffer; }
+    if (!strcmp(name, "glUnmapBuffer") || !strcmp(name, "glUnmapNamedBuffer")) { return headless_gl_true; }
+    if (!strcmp(name, "glGetBufferPointerv") || !strcmp(name, "glGetNamedBufferPointerv")) { return headless_gl_get_buffer_pointer; }
+    if (!strcmp(name, "glGetPointerv"))    { return headless_gl_get_pointer; }
+    if (!strcmp(name, "glFenceSync"))      { return headless_gl_fence_sync; }
+    if (!strcmp(name, "glClientWaitSync")) { return headless_gl_client_wait_sync; }
+    
+    // @Note: glGenTextures, glGenBuffers, glGenVertexArrays, ... all take a count and an array
+    if (!strncmp(name, "glGen", 5) && strcmp(name, "glGenerateMipmap") && strcmp(name, "glGenerateTextureMipmap")) {
+        return headless_gl_gen_names;
+    }
+    
+    return headless_gl_nothing;
+}
+
+// === game module
+#if GAME_HOT_RELOAD
+typedef struct {
+    void* library;
+    game_code code;
+    
+    u32 load_count;
+    bool changed;   // @Info: set by the file watch on game.so
+} linux_game_module;
+
+#define GAME_MODULE_PATH "./game.so"
+
+static bool linux_copy_file(char* from, char* to) {
+    int in = open(from, O_RDONLY | O_CLOEXEC);
+    if (in < 0) { return false; }
+    
+    int out = open(to, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0700);
+    if (out < 0) {
+        close(in);
+        return false;
+    }
+    
+    char buffer[kilobytes(64)];
+    ssize_t length;
+    bool copied = true;
+    while (copied && (length = read(in, buffer, sizeof(buffer))) > 0) { copied = write(out, buffer, length) == length; }
+    
+    close(in);
+    close(out);
+    return copied && length == 0;
+}
+
+// @Info: dlopen hands back the library it already has for a path it knows, so every load gets a copy of its own.
+//        The copy leaves the directory right away, the loaded library keeps it alive.
+static bool linux_load_game_module(linux_game_module* module) {
+    char path[64];
+    snprintf(path, sizeof(path), "./game_loaded_%d_%u.so", (int)getpid(), module->load_count++);
+    
+    if (!linux_copy_file(GAME_MODULE_PATH, path)) {
+        report("Could not copy %s: %s\n", GAME_MODULE_PATH, strerror(errno));
+        unlink(path);
+        return false;
+    }
+    
+    module->library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    unlink(path);
+    
+    if (!module->library) {
+        report("Could not load %s: %s\n", GAME_MODULE_PATH, dlerror());
+        return false;
+    }
+    
+    module->code = (game_code){
+        .init_memory        = (game_init_memory_proc*)dlsym(module->library, "game_init_memory"),
+        .update_and_render  = (game_update_and_render_proc*)dlsym(module->library, "game_update_and_render"),
+        .resize_window      = (game_resize_window_proc*)dlsym(module->library, "game_resize_window"),
+        .load_last_snapshot = (game_load_last_snapshot_proc*)dlsym(module->library, "game_load_last_snapshot"),
+        .unload             = (game_unload_proc*)dlsym(module->library, "game_unload"),
+        .reload             = (game_reload_proc*)dlsym(module->library, "game_reload") };
+    
+    game_code* code = &module->code;
+    if (!code->init_memory || !code->update_and_render || !code->resize_window || !code->load_last_snapshot ||
+        !code->unload || !code->reload) {
+        report("%s is missing some of the game functions\n", GAME_MODULE_PATH);
+        dlclose(module->library);
+        module->library = 0;
+        return false;
+    }
+    
+    return true;
+}
+
+static void linux_game_module_changed(string path, void* data) {
+    linux_game_module* module = data;
+    module->changed = true;
+}
+
+// @Info: once per frame. The new module gets loaded before the old one goes, so a broken build keeps the old one
+//        running. build.sh renames a finished build into place, a change is never half of one.
+static void linux_reload_game_module_if_changed(linux_game_module* module, platform_info* platform) {
+    if (!module->changed) { return; }
+    module->changed = false;
+    
+    linux_game_module new_module = { .load_count = module->load_count };
+    bool loaded = linux_load_game_module(&new_module);
+    module->load_count = new_module.load_count;
+    if (!loaded) { return; }
+    
+    module->code.unload(platform);
+    dlclose(module->library);
+    
+    module->library = new_module.library;
+    module->code = new_module.code;
+    module->code.reload(platform);
+}
+#endif
+
+// === offscreen GL
+typedef struct {
+    EGLDisplay display;
+    EGLSurface surface;
+    EGLContext context;
+} linux_egl_info;
+
+// @Note: the default display needs a running X or wayland server, build machines usually only have
+//        the surfaceless one
+static bool linux_init_egl(linux_egl_info* egl, int width, int height) {
+    egl->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    
+    EGLint major, minor;
+    if (!egl->display || !eglInitialize(egl->display, &major, &minor)) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        
+        egl->display = eglGetPlatformDisplayEXT ? eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0) : 0;
+        if (!egl->display || !eglInitialize(egl->display, &major, &minor)) {
+            report("Could not initialize an EGL display\n");
+            return false;
+        }
+    }
+    
+    EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    
+    EGLConfig config;
+    EGLint config_count;
+    if (!eglChooseConfig(egl->display, config_attribs, &config, 1, &config_count) || !config_count) {
+        report("Did not get an EGL config\n");
+        return false;
+    }
+    
+    // @Info: stands in for the window, so that framebuffer 0 exists like it does on windows
+    EGLint surface_attribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    egl->surface = eglCreatePbufferSurface(egl->display, config, surface_attribs);
+    if (egl->surface == EGL_NO_SURFACE) {
+        report("Could not create the EGL surface\n");
+        return false;
+    }
+    
+    eglBindAPI(EGL_OPENGL_API);
+    
+    // @Note: same version and profile as the windows context
+    EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 4,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    
+    egl->context = eglCreateContext(egl->display, config, EGL_NO_CONTEXT, context_attribs);
+    if (egl->context == EGL_NO_CONTEXT) {
+        report("Could not create an OpenGL 4.4 context\n");
+        return false;
+    }
+    
+    if (!eglMakeCurrent(egl->display, egl->surface, egl->surface, egl->context)) {
+        report("Could not make the OpenGL context current\n");
+        return false;
+    }
+    
+    return true;
+}
+
+// @Info:
+//    -headless       no GL context, every GL call goes nowhere
+//    -frames N       quits after N frames and reports how long they took, runs until killed otherwise
+//    -size WxH       size of the offscreen framebuffer, 1280x720 if not given
+//    -fps N          limits the frame rate, see frame_timing.c
+//    -resume         loads the last snapshot, DEV only (an unknown argument otherwise)
+int main(int argc, char** argv) {
+    setvbuf(stdout, 0, _IOLBF, 0);
+    
+    platform_info platform = { 0 };
+    platform.is_running = 1;
+    platform.window_width = 1280;
+    platform.window_height = 720;
+    
+    bool headless = false;
+#if DEV
+    bool resume = false;
+#endif
+    u64 frame_limit = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if      (!strcmp(argv[i], "-headless"))              { headless = true; }
+#if DEV
+        else if (!strcmp(argv[i], "-resume"))                { resume = true; }
+#endif
+        else if (!strcmp(argv[i], "-frames") && i + 1 < argc) { frame_limit = strtoull(argv[++i], 0, 10); }
+        else if (!strcmp(argv[i], "-fps") && i + 1 < argc)    { platform.target_frame_rate = atoi(argv[++i]); }
+        else if (!strcmp(argv[i], "-size") && i + 1 < argc)  {
+            sscanf(argv[++i], "%dx%d", &platform.window_width, &platform.window_height);
+        } else {
+            report("Unknown argument %s\n", argv[i]);
+            return 1;
+        }
+    }
+    
+    { // === allocate game memory
+        // @Info: this is only address space, pages get committed as the arenas grow
+        platform.permanent_storage_size = gigabytes(8);
+        platform.transient_storage_size = gigabytes(8);
+        
+#if DEV
+        void* game_memory_base = (void*)terabytes(1);
+#else
+        void* game_memory_base = 0;
+#endif
+        
+        // @Note: two separate reservations, so that loading a snapshot can replace the permanent one on its own
+        platform.permanent_storage = linux_reserve_memory(game_memory_base,
+            platform.permanent_storage_size + MEMORY_GUARD_SIZE);
+        
+        if (platform.permanent_storage) {
+            u8* transient_base = (u8*)platform.permanent_storage + platform.permanent_storage_size + MEMORY_GUARD_SIZE;
+            platform.transient_storage = linux_reserve_memory(transient_base, platform.transient_storage_size + MEMORY_GUARD_SIZE);
+        }
+        
+        if (!platform.permanent_storage || !platform.transient_storage) {
+            report("Failed to reserve the games memory\n");
+            return 1;
+        }
+    }
+    
+    linux_egl_info egl = { 0 };
+    { // === init opengl
+        if (headless) {
+            gladLoadGLLoader(headless_gl_get_proc_address);
+        } else {
+            if (!linux_init_egl(&egl, platform.window_width, platform.window_height)) { return 1; }
+            
+            if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+                report("Could not load the OpenGL functions\n");
+                return 1;
+            }
+            
+            report("OpenGL %s, %s\n", glGetString(GL_VERSION), glGetString(GL_RENDERER));
+        }
+    }
+    
+    platform.api = get_platform_api();
+    platform.gl_get_proc_address = headless ? headless_gl_get_proc_address : (void* (*)(const char*))eglGetProcAddress;
+    
+#if GAME_HOT_RELOAD
+    linux_game_module module = { 0 };
+    if (!linux_load_game_module(&module)) { return 1; }
+    
+    // @Note: before the game adds its own
+    linux_add_file_watch(string(GAME_MODULE_PATH), linux_game_module_changed, &module);
+    file_watch_keep_current();
+    
+    game_code* game = &module.code;
+#else
+    game_code unity_game = {
+        .init_memory        = game_init_memory,
+        .update_and_render  = game_update_and_render,
+        .resize_window      = game_resize_window,
+        .load_last_snapshot = game_load_last_snapshot };
+    game_code* game = &unity_game;
+#endif
+    
+    game->init_memory(&platform);
+    
+#if DEV
+    if (resume) { game->load_last_snapshot(&platform); }
+#endif
+    
+    frame_timer timer;
+    init_frame_timer(&timer, platform.target_frame_rate);
+    
+    u64 start_ticks = timer.frame_start;
+    u64 frame_count = 0;
+    
+    while (platform.is_running) {
+        frame_timer_begin_platform_frame(&timer, &platform);
+        check_file_watchers();
+#if GAME_HOT_RELOAD
+        linux_reload_game_module_if_changed(&module, &platform);
+#endif
+        
+        game->update_and_render(&platform);
+        
+        platform.event_count = 0;
+        if (!headless) { eglSwapBuffers(egl.display, egl.surface); }
+        
+        frame_count++;
+        if (frame_limit && frame_count >= frame_limit) { platform.is_running = false; }
+        
+        frame_timer_wait(&timer);
+    }
+    
+    if (!headless) { glFinish(); }
+    
+    double total_ms = (linux_get_ticks() - start_ticks) / 1000000.0;
+    report("%llu frames in %.1f ms, %.3f ms per frame\n", frame_count, total_ms, total_ms / MAX(frame_count, 1));
+    
+    frame_time_stats stats = frame_timer_get_stats(&timer);
+    report("last %u frames: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, worst %.3f ms\n", 
+           stats.sample_count, stats.p50, stats.p95, stats.p99, stats.worst);
+    
+    if (!headless) {
+        eglMakeCurrent(egl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglTerminate(egl.display);
+    }
+    
+    return 0;
+}
@@ -1,31 +1,600 @@
 #pragma once
 
+// @Info: enough for aligned loads of the widest vector registers the build uses
+#if VECTOR_SIMD_AVX2
+    #define SIMD_ALIGNMENT 32
+#else
+    #define SIMD_ALIGNMENT 16
+#endif
+
+// @Info: with MEMORY_TRACKING these pass the call site along, without it they are plain calls
+#if MEMORY_TRACKING
+    #define MEMORY_SITE_PARAMS , char* file, int line
+    #define MEMORY_SITE        , __FILE__, __LINE__
+    #define MEMORY_SITE_PASS   , file, line
+#else
+    #define MEMORY_SITE_PARAMS
+    #define MEMORY_SITE
+    #define MEMORY_SITE_PASS
+#endif
+
+// @Info: push_size has no alignment, consecutive pushes are contiguous
+#define push_size(arena, size)                    _push_size_aligned(arena, size, 1 MEMORY_SITE)
+#define push_size_aligned(arena, size, alignment) _push_size_aligned(arena, size, alignment MEMORY_SITE)
+#define push_size_zero(arena, size, alignment)    _push_size_zero(arena, size, alignment MEMORY_SITE)
+#define save_arena(arena)                         _save_arena(arena MEMORY_SITE)
+#define restore_arena(marker)                     _restore_arena(marker MEMORY_SITE)
+#define end_scratch(marker)                       _restore_arena(marker MEMORY_SITE)
+
+#define push_struct(arena, type)            ((type*)push_size_aligned(arena, sizeof(type), _Alignof(type)))
+#define push_array(arena, type, count)      ((type*)push_size_aligned(arena, sizeof(type) * (count), _Alignof(type)))
+#define push_array_zero(arena, type, count) ((type*)push_size_zero(arena, sizeof(type) * (count), _Alignof(type)))
+
+#if MEMORY_TRACKING
+// === allocation tracking
+//
+// @Info: every push, save and restore is counted per call site and arena. Arenas are stacks, so each arena keeps 
+//        a stack of which site pushed from what offset on, that way restores and clears can hand the bytes back 
+//        to the sites that pushed them and live/peak stay exact.
+
+#define MEMORY_TRACKING_SITE_COUNT   1024 // power of two
+#define MEMORY_TRACKING_ARENA_COUNT  16
+#define MEMORY_TRACKING_RECORD_COUNT 4096 // per arena, consecutive pushes from the same site share one
+#define MEMORY_TRACKING_NAMES_SIZE   kilobytes(16)
+
+enum {
+    MEMORY_SITE_PUSH,
+    MEMORY_SITE_SAVE,
+    MEMORY_SITE_RESTORE,
+};
+
+typedef struct {
+    char* file;         // 0 for free slots
+    int line;
+    int type;
+    void* arena_base;
+    
+    u64 count;
+    u64 bytes;          // pushed in total, for restores what they released in total
+    u64 live;           // pushes only, still in the arena
+    u64 peak;           // pushes only, highest live
+} memory_site;
+
+typedef struct {
+    u64 offset;
+    u32 site;
+} memory_record;
+
+typedef struct {
+    void* base;
+    char* name;
+    u64 used;           // end of the last record
+    
+    u32 record_count;
+    bool ran_out;       // later pushes got added to the last record, so the split between sites is off
+    memory_record records[MEMORY_TRACKING_RECORD_COUNT];
+} memory_arena_log;
+
+typedef struct memory_tracker {
+    memory_site sites[MEMORY_TRACKING_SITE_COUNT];
+    int site_count;
+    
+    memory_arena_log arenas[MEMORY_TRACKING_ARENA_COUNT];
+    int arena_count;
+    
+    // @Info: copies of the file and arena names, the ones the sites point at go away with a game module
+    char names[MEMORY_TRACKING_NAMES_SIZE];
+    u32 names_used;
+} memory_tracker;
+
+// @Note: the tracker starts out static, it has to track the permanent arena before there is a game_state to put it in.
+//        The game moves it into the permanent storage after that (see memory_tracking_move_to), so it stays across 
+//        reloads of the game module.
+static memory_tracker memory_tracking_startup;
+static memory_tracker* memory_tracking = &memory_tracking_startup;
+
+// @Note: the tracker is not synchronized, so only the thread that calls memory_tracking_track_this_thread 
+//        (the main thread) gets tracked
+static THREAD_LOCAL bool memory_tracking_this_thread;
+
+void memory_tracking_track_this_thread() {
+    memory_tracking_this_thread = true;
+}
+
+static memory_arena_log* memory_tracking_get_arena(void* base) {
+    if (!memory_tracking_this_thread) { return 0; }
+    
+    for (int i = 0; i < memory_tracking->arena_count; i++) {
+        if (memory_tracking->arenas[i].base == base) { return &memory_tracking->arenas[i]; }
+    }
+    
+    if (memory_tracking->arena_count == MEMORY_TRACKING_ARENA_COUNT) { return 0; }
+    
+    memory_arena_log* log = &memory_tracking->arenas[memory_tracking->arena_count++];
+    log->base = base;
+    log->name = "?";
+    return log;
+}
+
+static memory_site* memory_tracking_get_site(void* arena_base, int type, char* file, int line) {
+    if (!memory_tracking_this_thread) { return 0; }
+    
+    // @Note: not the file pointer, a reloaded module passes the same file at another address
+    u64 hash = (u64)line * 131 + type + ((u64)arena_base >> 16);
+    
+    for (int i = 0; i < MEMORY_TRACKING_SITE_COUNT; i++) {
+        memory_site* site = &memory_tracking->sites[(hash + i) & (MEMORY_TRACKING_SITE_COUNT - 1)];
+        
+        if (!site->file) {
+            site->file = file;
+            site->line = line;
+            site->type = type;
+            site->arena_base = arena_base;
+            memory_tracking->site_count++;
+            return site;
+        }
+        
+        if (site->line == line && site->type == type && site->arena_base == arena_base) { 
+            if (site->file == file) { return site; }
+            
+            // @Note: a site from before a reload, it points at its kept name until it is hit again
+            if (strcmp(site->file, file) == 0) {
+                site->file = file;
+                return site;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+// @Info: hands everything past used back to the sites that pushed it
+static void memory_tracking_release(memory_arena_log* log, u64 used) {
+    u64 end = log->used;
+    
+    while (log->record_count && end > used) {
+        memory_record* record = &log->records[log->record_count - 1];
+        u64 start = MAX(record->offset, used);
+        
+        memory_site* site = &memory_tracking->sites[record->site];
+        site->live -= MIN(site->live, end - start);
+        
+        if (record->offset < used) { break; }
+        end = record->offset;
+        log->record_count--;
+    }
+    
+    log->used = used;
+}
+
+static void memory_tracking_push(memory_arena* arena, u64 old_used, char* file, int line) {
+    memory_arena_log* log = memory_tracking_get_arena(arena->base);
+    memory_site* site = memory_tracking_get_site(arena->base, MEMORY_SITE_PUSH, file, line);
+    if (!log || !site) { return; }
+    
+    u32 site_index = (u32)(site - memory_tracking->sites);
+    u64 size = arena->used - old_used;
+    
+    site->count++;
+    site->bytes += size;
+    
+    memory_record* last = log->record_count ? &log->records[log->record_count - 1] : 0;
+    if (last && last->site != site_index) {
+        if (log->record_count < MEMORY_TRACKING_RECORD_COUNT) { last = 0; }
+        else                                                  { log->ran_out = true; }
+    }
+    
+    if (!last) {
+        log->records[log->record_count++] = (memory_record) { .offset = old_used, .site = site_index };
+        last = &log->records[log->record_count - 1];
+    }
+    
+    memory_site* owner = &memory_tracking->sites[last->site];
+    owner->live += size;
+    owner->peak = MAX(owner->peak, owner->live);
+    log->used = arena->used;
+}
+
+static void memory_tracking_count(memory_arena* arena, int type, u64 bytes, char* file, int line) {
+    memory_site* site = memory_tracking_get_site(arena->base, type, file, line);
+    if (!site) { return; }
+    
+    site->count++;
+    site->bytes += bytes;
+}
+
+// @Info: for when everything in the arena got replaced at once, it is attributed to the caller from then on
+#define memory_tracking_replace_arena(arena) _memory_tracking_replace_arena(arena, __FILE__, __LINE__)
+void _memory_tracking_replace_arena(memory_arena* arena, char* file, int line) {
+    memory_arena_log* log = memory_tracking_get_arena(arena->base);
+    if (!log) { return; }
+    
+    memory_tracking_release(log, 0);
+    memory_tracking_push(arena, 0, file, line);
+}
+
+void memory_tracking_name_arena(memory_arena* arena, char* name) {
+    memory_arena_log* log = memory_tracking_get_arena(arena->base);
+    if (log) { log->name = name; }
+}
+
+// @Info: moves everything tracked so far into tracker and keeps tracking there
+void memory_tracking_move_to(memory_tracker* tracker) {
+    if (tracker == memory_tracking) { return; }
+    
+    *tracker = *memory_tracking;
+    memory_tracking = tracker;
+}
+
+// @Info: for a game module that got reloaded, tracker is where the old one left off
+void memory_tracking_use(memory_tracker* tracker) {
+    memory_tracking = tracker;
+}
+
+static char* memory_tracking_keep_name(char* name) {
+    memory_tracker* tracker = memory_tracking;
+    
+    for (u32 at = 0; at < tracker->names_used; at += strlen(&tracker->names[at]) + 1) {
+        if (strcmp(&tracker->names[at], name) == 0) { return &tracker->names[at]; }
+    }
+    
+    // @Note: the last byte is never handed out, so it is an empty name for when the table is full
+    u32 length = strlen(name) + 1;
+    if (tracker->names_used + length >= MEMORY_TRACKING_NAMES_SIZE) { return &tracker->names[MEMORY_TRACKING_NAMES_SIZE - 1]; }
+    
+    char* result = &tracker->names[tracker->names_used];
+    memcpy(result, name, length);
+    tracker->names_used += length;
+    return result;
+}
+
+// @Info: before the game module gets unloaded, the sites and arenas point into its constants
+void memory_tracking_keep_names() {
+    for (int i = 0; i < MEMORY_TRACKING_SITE_COUNT; i++) {
+        memory_site* site = &memory_tracking->sites[i];
+        if (site->file) { site->file = memory_tracking_keep_name(site->file); }
+    }
+    
+    for (int i = 0; i < memory_tracking->arena_count; i++) {
+        memory_tracking->arenas[i].name = memory_tracking_keep_name(memory_tracking->arenas[i].name);
+    }
+}
+
+static char* memory_tracking_get_arena_name(void* base) {
+    memory_arena_log* log = memory_tracking_get_arena(base);
+    return log ? log->name : "?";
+}
+
+static char* memory_tracking_short_file(char* file) {
+    char* result = file;
+    for (char* c = file; *c; c++) {
+        if (*c == '/' || *c == '\\') { result = c + 1; }
+    }
+    return result;
+}
+
+static bool memory_site_is_bigger(memory_site* a, memory_site* b) {
+    return a->peak > b->peak || (a->peak == b->peak && a->bytes > b->bytes);
+}
+
+// @Info: fills sites with the biggest ones, highest peak first (most bytes for saves and restores), returns how many
+int memory_tracking_get_sorted_sites(memory_site** sites, int max_count) {
+    int count = 0;
+    
+    for (int i = 0; i < MEMORY_TRACKING_SITE_COUNT; i++) {
+        memory_site* site = &memory_tracking->sites[i];
+        if (!site->file) { continue; }
+        
+        if (count == max_count) {
+            if (!memory_site_is_bigger(site, sites[count - 1])) { continue; }
+            count--;
+        }
+        
+        // @Note: insertion sort, there are only a few hundred sites at most
+        int j = count++;
+        while (j > 0 && memory_site_is_bigger(site, sites[j - 1])) {
+            sites[j] = sites[j - 1];
+            j--;
+        }
+        sites[j] = site;
+    }
+    
+    return count;
+}
+
+void memory_tracking_write_report(FILE* file, bool as_csv) {
+    static memory_site* sites[MEMORY_TRACKING_SITE_COUNT];
+    int count = memory_tracking_get_sorted_sites(sites, array_count(sites));
+    
+    char* type_names[] = { "push", "save", "restore" };
+    
+    if (as_csv) { fprintf(file, "arena,file,line,type,count,bytes,live,peak\n"); }
+    else        { fprintf(file, "%-12s %-24s %-8s %10s %14s %14s %14s\n", 
+                          "arena", "site", "type", "count", "bytes", "live", "peak"); }
+    
+    for (int i = 0; i < count; i++) {
+        memory_site* site = sites[i];
+        char* arena_name = memory_tracking_get_arena_name(site->arena_base);
+        char* file_name = memory_tracking_short_file(site->file);
+        
+        if (as_csv) {
+            fprintf(file, "%s,%s,%d,%s,%llu,%llu,%llu,%llu\n", arena_name, file_name, site->line, 
+                    type_names[site->type], site->count, site->bytes, site->live, site->peak);
+        } else {
+            char location[64];
+            snprintf(location, sizeof(location), "%s:%d", file_name, site->line);
+            fprintf(file, "%-12s %-24s %-8s %10llu %14llu %14llu %14llu\n", arena_name, location, 
+                    type_names[site->type], site->count, site->bytes, site->live, site->peak);
+        }
+    }
+    
+    for (int i = 0; i < memory_tracking->arena_count; i++) {
+        if (memory_tracking->arenas[i].ran_out) {
+            fprintf(file, "%s%s ran out of records, its live and peak counts are approximate\n", 
+                    as_csv ? "# " : "", memory_tracking->arenas[i].name);
+        }
+    }
+}
+#else
+    #define memory_tracking_name_arena(...)
+    #define memory_tracking_track_this_thread()
+    #define memory_tracking_replace_arena(...)
+    #define memory_tracking_keep_names()
+#endif
+
+// @Info: for memory that is usable as it is
 void init_arena(memory_arena* arena, u64 size, void* base) {
     arena->base = base;
     arena->size = size;
     arena->used = 0;
-    arena->_saved_count = 0;
+    arena->committed = size;
+    arena->high_water = 0;
+    
+#if MEMORY_TRACKING
+    memory_arena_log* log = memory_tracking_get_arena(base);
+    if (log) { memory_tracking_release(log, 0); }
+#endif
+}
+
+// @Info: for page aligned memory from platform_reserve_memory, pages get committed as the arena grows
+void init_reserved_arena(memory_arena* arena, u64 size, void* base) {
+    init_arena(arena, size, base);
+    arena->committed = 0;
+}
+
+static bool arena_commit(memory_arena* arena, u64 needed) {
+    u64 target = (needed + ARENA_COMMIT_SIZE - 1) / ARENA_COMMIT_SIZE * ARENA_COMMIT_SIZE;
+    target = MIN(target, arena->size);
+    
+    if (!platform_commit_memory((u8*)arena->base + arena->committed, target - arena->committed)) {
+        report("Failed to commit %llu bytes of arena memory\n", target - arena->committed);
+        return false;
+    }
+    
+    arena->committed = target;
+    return true;
 }
 
 void clear_arena(memory_arena* arena) {
     arena->used = 0;
-    arena->_saved_count = 0;
+    arena->high_water = 0;
+    
+#if MEMORY_TRACKING
+    memory_arena_log* log = memory_tracking_get_arena(arena->base);
+    if (log) { memory_tracking_release(log, 0); }
+#endif
+}
+
+arena_marker _save_arena(memory_arena* arena MEMORY_SITE_PARAMS) {
+#if MEMORY_TRACKING
+    memory_tracking_count(arena, MEMORY_SITE_SAVE, 0, file, line);
+#endif
+    
+    return (arena_marker) { .arena = arena, .used = arena->used };
+}
+
+// @Note: markers have to be restored innermost first, restoring an outer one frees what the inner ones saved as well
+void _restore_arena(arena_marker marker MEMORY_SITE_PARAMS) {
+    memory_arena* arena = marker.arena;
+    assert(marker.used <= arena->used);
+    
+#if MEMORY_TRACKING
+    u64 old_used = arena->used;
+#endif
+    
+    arena->used = marker.used;
+    
+#if MEMORY_TRACKING
+    memory_tracking_count(arena, MEMORY_SITE_RESTORE, old_used - arena->used, file, line);
+    memory_arena_log* log = memory_tracking_get_arena(arena->base);
+    if (log) { memory_tracking_release(log, arena->used); }
+#endif
+}
+
+// @Info: alignment has to be a power of two, it applies to the address and not the offset into the arena
+void* _push_size_aligned(memory_arena* arena, u64 size, u64 alignment MEMORY_SITE_PARAMS) {
+    assert(alignment && !(alignment & (alignment - 1)));
+    
+    u64 address = (u64)arena->base + arena->used;
+    u64 padding = (0 - address) & (alignment - 1);
+    u64 needed = arena->used + padding + size;
+    assert(needed <= arena->size);
+    
+    if (needed > arena->committed) {
+        if (!arena_commit(arena, needed)) { return 0; }
+    }
+    
+    void* result = (u8*)arena->base + arena->used + padding;
+    
+#if MEMORY_TRACKING
+    u64 old_used = arena->used;
+#endif
+    
+    arena->used = needed;
+    arena->high_water = MAX(arena->high_water, arena->used);
+    
+#if MEMORY_TRACKING
+    memory_tracking_push(arena, old_used, file, line);
+#endif
+    
+    return result;
+}
+
+// @Note: freshly committed pages are zero already, but memory from before a clear or restore is not
+void* _push_size_zero(memory_arena* arena, u64 size, u64 alignment MEMORY_SITE_PARAMS) {
+    void* result = _push_size_aligned(arena, size, alignment MEMORY_SITE_PASS);
+    if (result) { memset(result, 0, size); }
+    return result;
+}
+
+
+// === scratch arenas
+//
+// @Info: every thread has two scratch arenas, reserved the first time it asks for one. begin_scratch hands out the 
+//        one that is not conflict, so a function can take the arena its results go into (which may be its caller's 
+//        scratch) and still get temporary memory that does not overwrite them:
+//
+//            arena_marker scratch = begin_scratch(result_arena);
+//            ... push_array(scratch.arena, ...) ...
+//            end_scratch(scratch);
+
+// @Note: the scratch memory of a thread is only released by release_scratch_arenas, threads are expected to live
+//        until the game exits
+static THREAD_LOCAL memory_arena scratch_arenas[2];
+
+static memory_arena* get_scratch_arena(int index) {
+    memory_arena* arena = &scratch_arenas[index];
+    
+    if (!arena->base) {
+        void* base = platform_reserve_memory(0, SCRATCH_ARENA_SIZE + MEMORY_GUARD_SIZE);
+        if (!base) {
+            report("Failed to reserve scratch arena memory\n");
+            assert(false);
+            return 0;
+        }
+        
+        init_reserved_arena(arena, SCRATCH_ARENA_SIZE, base);
+        memory_tracking_name_arena(arena, index ? "scratch_1" : "scratch_0");
+    }
+    
+    return arena;
 }
 
-void save_arena(memory_arena* arena) {
-    assert(arena->_saved_count < array_count(arena->_saved));
-    arena->_saved[arena->_saved_count++] = arena->used;
+// @Info: for the calling thread, before a game module that owns the thread locals gets unloaded
+static void release_scratch_arenas() {
+    for (int i = 0; i < array_count(scratch_arenas); i++) {
+        memory_arena* arena = &scratch_arenas[i];
+        if (!arena->base) { continue; }
+        
+        platform_release_memory(arena->base, SCRATCH_ARENA_SIZE + MEMORY_GUARD_SIZE);
+        *arena = (memory_arena){ 0 };
+    }
 }
 
-void restore_arena(memory_arena* arena) {
-    assert(arena->_saved_count > 0);
-    arena->used = arena->_saved[--arena->_saved_count];
+#define begin_scratch(conflict) _begin_scratch(conflict MEMORY_SITE)
+arena_marker _begin_scratch(memory_arena* conflict MEMORY_SITE_PARAMS) {
+    memory_arena* arena = get_scratch_arena(0);
+    if (arena == conflict) { arena = get_scratch_arena(1); }
+    
+    return _save_arena(arena MEMORY_SITE_PASS);
 }
 
-void* push_size(memory_arena* arena, u64 size) {
-    assert(arena->used + size <= arena->size);
-    void* result = (u8*)arena->base + arena->used;
-    arena->used += size;
+// === pools
+//
+// @Info: O(1) alloc and free of fixed size elements. The arena memory is never given back, freed elements go on a 
+//        free list that is stored in the elements themselves. The arena must outlive the pool and must not be 
+//        cleared or restored below the pool's blocks.
+
+#define MEMORY_POOL_ALLOC_POISON 0xCD
+#define MEMORY_POOL_FREE_POISON  0xDD
+#define MEMORY_POOL_FREE_TAG     0xF4EEF4EEF4EEF4EEull
+
+typedef struct memory_pool_node {
+    struct memory_pool_node* next;
+#if MEMORY_POOL_DEBUG
+    u64 tag;    // @Info: MEMORY_POOL_FREE_TAG while on the free list
+#endif
+} memory_pool_node;
+
+#define init_pool_for(pool, arena, type, block_count) init_pool(pool, arena, sizeof(type), _Alignof(type), block_count)
+#define pool_alloc_struct(pool, type)                 ((type*)pool_alloc(pool))
+
+void init_pool(memory_pool* pool, memory_arena* arena, u32 element_size, u32 alignment, u32 block_count) {
+    assert(alignment && !(alignment & (alignment - 1)));
+    assert(block_count > 0);
+    
+    alignment = MAX(alignment, (u32)_Alignof(memory_pool_node));
+    element_size = MAX(element_size, (u32)sizeof(memory_pool_node));
+    element_size = (element_size + alignment - 1) & ~(alignment - 1);
+    
+    *pool = (memory_pool) {
+        .arena = arena,
+        .element_size = element_size,
+        .alignment = alignment,
+        .block_count = block_count,
+    };
+}
+
+// @Info: returns 0 when the arena is full
+void* pool_alloc(memory_pool* pool) {
+    void* result = 0;
+    
+    if (pool->free_list) {
+        memory_pool_node* node = pool->free_list;
+        pool->free_list = node->next;
+        result = node;
+    } else {
+        if (!pool->block_remaining) {
+            pool->block_cursor = push_size_aligned(pool->arena, (u64)pool->element_size * pool->block_count, pool->alignment);
+            if (!pool->block_cursor) { return 0; }
+            
+            pool->block_remaining = pool->block_count;
+            pool->capacity += pool->block_count;
+        }
+        
+        result = pool->block_cursor;
+        pool->block_cursor += pool->element_size;
+        pool->block_remaining--;
+    }
+    
+    pool->used_count++;
+    
+#if MEMORY_POOL_DEBUG
+    memset(result, MEMORY_POOL_ALLOC_POISON, pool->element_size);
+#endif
+    
     return result;
 }
 
+#if MEMORY_POOL_DEBUG
+static bool pool_is_on_free_list(memory_pool* pool, void* element) {
+    for (memory_pool_node* node = pool->free_list; node; node = node->next) {
+        if (node == element) { return true; }
+    }
+    return false;
+}
+#endif
+
+void pool_free(memory_pool* pool, void* element) {
+    if (!element) { return; }
+    
+    memory_pool_node* node = element;
+    
+#if MEMORY_POOL_DEBUG
+    // @Note: the tag alone could also be user data, walking the free list only happens when it matches
+    if (node->tag == MEMORY_POOL_FREE_TAG && pool_is_on_free_list(pool, element)) {
+        report("Pool element %p was freed twice\n", element);
+        assert(!"double free");
+        return;
+    }
+    
+    memset(element, MEMORY_POOL_FREE_POISON, pool->element_size);
+    node->tag = MEMORY_POOL_FREE_TAG;
+#endif
+    
+    assert(pool->used_count > 0);
+    pool->used_count--;
+    
+    node->next = pool->free_list;
+    pool->free_list = node;
+}
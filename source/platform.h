@@ -1,6 +1,60 @@
 #pragma once
 
-void platform_handle_failed_assertion(char*, char*, int);
-void platform_add_file_watch(string, void (*callback)(string, void*), void*);
-int platform_find_all_files(char* dir, char* format, void* memory, unsigned long long* bytes_used);
-void platform_sleep(u64);
+// @Info: what a platform layer implements. The unity build calls these directly, a game module (GAME_MODULE,
+//        see game_module.c) has a pointer of the same name for each, filled in from platform_info.api.
+//
+//        find_all_files writes the zero terminated names one after another, it stops before the first one that
+//        does not fit into capacity.
+//
+//        get_ticks is monotonic high resolution time.
+//
+//        The memory functions are page level virtual memory. Reserved memory only takes up address space and
+//        faults on any access until it is committed, committed pages start out zeroed.
+//
+//        map_file_into_reserved puts a copy on write view of size bytes of the file at offset at the start of a
+//        region from reserve_memory, the rest of the region is only reserved again. Offset has to be a multiple
+//        of 64K. If it fails the whole region is only reserved.
+#define PLATFORM_API(X) \
+    X(void,               handle_failed_assertion, (char*, char*, int)) \
+    X(void,               add_file_watch,          (string, void (*callback)(string, void*), void*)) \
+    X(void,               clear_file_watches,      ()) \
+    X(int,                find_all_files,          (char* dir, char* format, void* memory, unsigned long long capacity, \
+                                                    unsigned long long* bytes_used)) \
+    X(void,               sleep,                   (unsigned long long)) \
+    X(unsigned long long, get_ticks,               ()) \
+    X(unsigned long long, get_tick_frequency,      ()) \
+    X(void*,              map_file,                (char* path, unsigned long long size, unsigned long long* mapped_size)) \
+    X(void,               unmap_file,              (void* memory)) \
+    X(unsigned long long, get_page_size,           ()) \
+    X(void*,              reserve_memory,          (void* base, unsigned long long size)) \
+    X(bool,               commit_memory,           (void* memory, unsigned long long size)) \
+    X(void,               decommit_memory,         (void* memory, unsigned long long size)) \
+    X(void,               release_memory,          (void* memory, unsigned long long size)) \
+    X(bool,               map_file_into_reserved,  (char* path, unsigned long long offset, unsigned long long size, \
+                                                    void* base, unsigned long long region_size))
+
+#define PLATFORM_API_POINTER(result, name, params) result (*name) params;
+typedef struct {
+    PLATFORM_API(PLATFORM_API_POINTER)
+} platform_api;
+
+#if GAME_MODULE
+    #define PLATFORM_API_DECLARATION(result, name, params) static result (*platform_##name) params;
+#else
+    #define PLATFORM_API_DECLARATION(result, name, params) result platform_##name params;
+#endif
+PLATFORM_API(PLATFORM_API_DECLARATION)
+
+#if GAME_MODULE
+    #define PLATFORM_API_LOAD(result, name, params) platform_##name = api->name;
+    static void load_platform_api(platform_api* api) {
+        PLATFORM_API(PLATFORM_API_LOAD)
+    }
+#else
+    #define PLATFORM_API_FILL(result, name, params) api.name = platform_##name;
+    static platform_api get_platform_api() {
+        platform_api api;
+        PLATFORM_API(PLATFORM_API_FILL)
+        return api;
+    }
+#endif
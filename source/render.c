@@ -56,8 +56,8 @@ mesh load_obj(char* file_path) {
         if (string_compare(prefix, face_prefix)) { index_count += 3; }
     }   
     
-    vertex* vertices = push_transient(sizeof(vertices[0]) * vertex_count * 3);
-    u32* indices     = push_transient(sizeof(indices[0]) * index_count);
+    vertex* vertices = push_array(&global->transient_arena, vertex, vertex_count * 3);
+    u32* indices     = push_array(&global->transient_arena, u32, index_count);
 
     int vertex_i = 0;
     int index_i = 0;
@@ -178,8 +178,8 @@ static mesh make_thruster_mesh() {
     int index_count = n * 12;
     int vertex_count = n * 3;
     
-    vertex* vertices = push_transient(sizeof(vertices[0]) * vertex_count);
-    u32* indices     = push_transient(sizeof(indices[0]) * index_count);
+    vertex* vertices = push_array(&global->transient_arena, vertex, vertex_count);
+    u32* indices     = push_array(&global->transient_arena, u32, index_count);
     
     int index_counter = 0;
     for (int i = 0; i < n; i++) {
@@ -295,8 +295,8 @@ static mesh make_round_plate_mesh(float width) {
     int index_count  = n * 6 + (n / 2 - 1) * 12;
     int vertex_count = n * 2;
     
-    vertex* vertices = push_transient(sizeof(vertices[0]) * vertex_count);
-    u32* indices     = push_transient(sizeof(indices[0]) * index_count);
+    vertex* vertices = push_array(&global->transient_arena, vertex, vertex_count);
+    u32* indices     = push_array(&global->transient_arena, u32, index_count);
     
     int index_counter = 0;
     
@@ -556,8 +556,8 @@ static mesh make_quarter_tube_mesh() {
     
     int index_counter = 0;
 
-    vertex* vertices = push_transient(sizeof(vertex) * vertex_count);
-    u32* indices = push_transient(sizeof(u32) * index_count);
+    vertex* vertices = push_array(&global->transient_arena, vertex, vertex_count);
+    u32* indices     = push_array(&global->transient_arena, u32, index_count);
 
     for (int i = 0; i < n; i++) {
         vertices[i * 2    ].p = vec3(cos(theta * i) - .5, sin(theta * i) - 0.5, -.5);
@@ -812,14 +812,6 @@ void init_renderer(game_state* state) {
     
     glEnable(GL_SCISSOR_TEST);
     
-    renderer->projection_matrix = make_projection_matrix(
-        window_w,  
-        window_h,
-        state->current_camera->fov,
-        state->current_camera->near,
-        state->current_camera->far
-    );
-    
     renderer->line_mesh = make_line_mesh();
     renderer->quad_mesh = make_quad_mesh();
     renderer->cube_mesh = make_cube_mesh();
@@ -925,14 +917,15 @@ bool shader_set_mat4(shader_info* shader, char* name, mat4 m) {
 u32 compile_shader(string source, u32 type) {
     u32 result = glCreateShader(type);
     
-    glShaderSource(result, 1, &source.data, &source.length);
+    int length = source.length;
+    glShaderSource(result, 1, (const char**)&source.data, &length);
     glCompileShader(result);
     
     int compiled;
     glGetShaderiv(result, GL_COMPILE_STATUS, &compiled);
 
     if (!compiled) {
-        u8 info[1024];
+        char info[1024];
         
         glGetShaderInfoLog(result, 1024, 0, info);
         report("Failed to compile shader: %s\n", info);
@@ -992,7 +985,7 @@ u32 load_shader(string source) {
     glGetProgramiv(result, GL_LINK_STATUS, &linked);
     
     if (!linked) {
-        u8 info[1024];
+        char info[1024];
         glGetProgramInfoLog(result, 1024, NULL, info);
         report("Failed to link shader: %s\n", info);
         
@@ -1037,16 +1030,14 @@ void reload_shader(string path, void* _shader) {
 }
 
 void load_all_shaders(game_state* state, char* shader_dir) {
-    u8* file_names = push_size(&state->transient_arena, 0);
-    
-    u64 bytes_used;
-    int file_count = platform_find_all_files(shader_dir, "*.glsl", file_names, &bytes_used);
-    
-    push_size(&state->transient_arena, bytes_used);
+    // @Note: only pushed memory is committed, so the names get a buffer of their own up front
+    u64 file_names_size = kilobytes(64);
+    char* file_names = push_size(&state->transient_arena, file_names_size);
+    int file_count = platform_find_all_files(shader_dir, "*.glsl", file_names, file_names_size, 0);
     
     shader_catalog* catalog = &state->shaders;
 
-    catalog->shaders = push_size(&state->permanent_arena, sizeof(shader_info) * file_count);
+    catalog->shaders = push_array(&state->permanent_arena, shader_info, file_count);
     catalog->count = file_count;
     
     string shader_path = string_buffer(256);
@@ -1063,13 +1054,14 @@ void load_all_shaders(game_state* state, char* shader_dir) {
         shader->path = push_string(&state->permanent_arena, shader_path.length);
         string_copy(&shader->path, shader_path);
         shader->name = get_file_name_from_path(shader->path);
+        shader->name_id = string_intern(&state->strings, shader->name);
         
         string shader_source = read_file(shader->path, &state->transient_arena);
         shader->id = load_shader(shader_source);
         
         if (!shader->id) {
             failed++;
-            report("Failed to load shader \"%*s\"\n", shader->name.length, shader->name.data);
+            report("Failed to load shader \"%.*s\"\n", shader->name.length, shader->name.data);
         }
         
         shader_path.length = shader_dir_length;
@@ -1082,11 +1074,15 @@ void load_all_shaders(game_state* state, char* shader_dir) {
     report("%i/%i shaders loaded\n", catalog->count, file_count);
 }
 
-shader_info* get_shader(char* _name) {
-    string name = { .data = _name, .length = c_string_length(_name), .size = name.length };
-    for (int i = 0; i < global->shaders.count; i++) {
+// @Note: only takes string literals, for anything else intern it and use get_shader_by_id()
+#define get_shader(NAME) get_shader_by_id(string_intern_find(&global->strings, string_literal(NAME)))
+
+shader_info* get_shader_by_id(string_id name_id) {
+    if (name_id == STRING_ID_NONE) { return 0; }
+    
+    for (u32 i = 0; i < global->shaders.count; i++) {
         shader_info* shader = &global->shaders.shaders[i];
-        if (string_compare(name, shader->name)) {
+        if (shader->name_id == name_id) {
             return shader;
         }
     }
@@ -1137,8 +1133,6 @@ void reload_texture(string path, void* _texture) {
     texture_info* texture = _texture;
     assert(string_compare(path, texture->path));
     
-    platform_sleep(100);
-    
     int w, h;
     u32 id = load_texture(path.data, &w, &h);
     
@@ -1156,15 +1150,13 @@ void reload_texture(string path, void* _texture) {
 }
 
 void load_all_textures(game_state* state, char* texture_dir) {
-    u8* file_names = push_size(&state->transient_arena, 0);
-    
-    u64 bytes_used;
-    int file_count = platform_find_all_files(texture_dir, "*.png", file_names, &bytes_used);
-    
-    push_size(&state->transient_arena, bytes_used);
+    // @Note: only pushed memory is committed, so the names get a buffer of their own up front
+    u64 file_names_size = kilobytes(64);
+    char* file_names = push_size(&state->transient_arena, file_names_size);
+    int file_count = platform_find_all_files(texture_dir, "*.png", file_names, file_names_size, 0);
     
     texture_catalog* catalog = &state->textures;
-    catalog->textures = push_size(&state->permanent_arena, sizeof(texture_info) * file_count);
+    catalog->textures = push_array(&state->permanent_arena, texture_info, file_count);
     catalog->count = file_count;
     
     string texture_path = string_buffer(256);
@@ -1183,6 +1175,7 @@ void load_all_textures(game_state* state, char* texture_dir) {
         string_copy(&texture->path, texture_path);
         texture->path.data[texture_path.length] = 0;
         texture->name = get_file_name_from_path(texture->path);
+        texture->name_id = string_intern(&state->strings, texture->name);
         
         texture->id = load_texture(texture->path.data, &texture->w, &texture->h);
         
@@ -1201,11 +1194,15 @@ void load_all_textures(game_state* state, char* texture_dir) {
     printf("%i/%i textures loaded\n", catalog->count - failed, catalog->count);
 }
 
-texture_info* get_texture(char* _name) {
-    string name = { .data = _name, .length = c_string_length(_name), .size = name.length };
-    for (int i = 0; i < global->textures.count; i++) {
+// @Note: only takes string literals, for anything else intern it and use get_texture_by_id()
+#define get_texture(NAME) get_texture_by_id(string_intern_find(&global->strings, string_literal(NAME)))
+
+texture_info* get_texture_by_id(string_id name_id) {
+    if (name_id == STRING_ID_NONE) { return 0; }
+    
+    for (u32 i = 0; i < global->textures.count; i++) {
         texture_info* texture = &global->textures.textures[i];
-        if (string_compare(name, texture->name)) {
+        if (texture->name_id == name_id) {
             return texture;
         }
     }
@@ -1316,8 +1313,8 @@ static void _render_mesh_basic(mesh m, render_mesh_args args) {
     mat4 model = make_model_matrix(translation, 
                                    vec_mul(vec_mul(args.scale_v, args.scale), m.scale), 
                                    quat_mul_quat(args.rotation, m.rotation));
-    mat4 view = global->current_camera->view_matrix;
-    mat4 proj = global->renderer.projection_matrix;
+    mat4 view = global->renderer.camera.view;
+    mat4 proj = global->renderer.camera.projection;
     
     shader_set_uniform(shader, "model", model);
     shader_set_uniform(shader, "view", view);
@@ -1338,8 +1335,8 @@ static void render_mesh(mesh m, shader_info* shader) {
     glUseProgram(shader->id);
     
     mat4 model = make_model_matrix(m.translation, m.scale, m.rotation);
-    mat4 view = global->current_camera->view_matrix;
-    mat4 proj = global->renderer.projection_matrix;
+    mat4 view = global->renderer.camera.view;
+    mat4 proj = global->renderer.camera.projection;
     
     shader_set_uniform(shader, "model", model);
     shader_set_uniform(shader, "view", view);
@@ -1358,8 +1355,8 @@ static void debug_render_quad(vec3 p0, vec3 p1, color c) {
     
     mesh m = global->renderer.line_mesh;
 
-    mat4 view = global->current_camera->view_matrix;
-    mat4 proj = global->renderer.projection_matrix;
+    mat4 view = global->renderer.camera.view;
+    mat4 proj = global->renderer.camera.projection;
 
     shader_set_uniform(shader, "view", view);
     shader_set_uniform(shader, "projection", proj);
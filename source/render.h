@@ -2,6 +2,7 @@
 
 typedef struct {
     string name;
+    string_id name_id;
     string path;
     u32 id;
 } shader_info;
@@ -13,6 +14,7 @@ typedef struct {
 
 typedef struct {
     string name;
+    string_id name_id;
     string path;
     u32 id;
     int w, h;
@@ -55,8 +57,29 @@ typedef struct {
     framebuffer_attachment attachments[FRAMEBUFFER_ATTACHMENT_MAX_COUNT];
 } framebuffer_info;
 
+// @Info: camera matrices for the current frame, everything that needs them reads them from here.
+//        They only get rebuilt when the camera or the window size changed (see camera_update_constants).
 typedef struct {
-    mat4 projection_matrix;
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    
+    mat4 inverse_view;
+    mat4 inverse_projection;
+    mat4 inverse_view_projection;
+    
+    // @Note: what the matrices above were built from
+    struct {
+        bool valid;
+        void* camera;
+        vec3 position, forward, up, right;
+        float fov, near, far;
+        int window_width, window_height;
+    } source;
+} camera_constants;
+
+typedef struct {
+    camera_constants camera;
     
     mesh line_mesh;
     mesh quad_mesh;
@@ -79,4 +102,4 @@ typedef struct {
                                                           vec3: shader_set_vec3,    \
                                                           vec4: shader_set_vec4,    \
                                                           mat4: shader_set_mat4     \
-                                                          ) (shader, name, x)
\ No newline at end of file
+                                                          ) (shader, name, x)
@@ -1,16 +1,496 @@
 #pragma once
 
-collision_quad cube_collision_quads[6] = {
-    { .a = { 0.5, -.5, -.5 }, .b = { 0.5, 0.5, 0.5 } },
-    { .a = { -.5, 0.5, -.5 }, .b = { 0.5, 0.5, 0.5 } },
-    { .a = { -.5, -.5, 0.5 }, .b = { 0.5, 0.5, 0.5 } },
-    { .a = { -.5, -.5, 0.5 }, .b = { -.5, 0.5, -.5 } },
-    { .a = { -.5, -.5, -.5 }, .b = { 0.5, -.5, 0.5 } },
-    { .a = { -.5, -.5, -.5 }, .b = { 0.5, 0.5, -.5 } }
+#include <time.h>
+
+// === orientations
+static quat ship_orientation_matrix_to_quat(s8 m[3][3]) {
+    // @Note: R(row, column), the matrix is stored column major
+    #define R(r, c) ((float)m[c][r])
+    quat result;
+    
+    float trace = R(0, 0) + R(1, 1) + R(2, 2);
+    if (trace > 0) {
+        float s = sqrtf(trace + 1.f) * 2.f;
+        result = (quat) { (R(2, 1) - R(1, 2)) / s, (R(0, 2) - R(2, 0)) / s, (R(1, 0) - R(0, 1)) / s, s / 4.f };
+    } else if (R(0, 0) > R(1, 1) && R(0, 0) > R(2, 2)) {
+        float s = sqrtf(1.f + R(0, 0) - R(1, 1) - R(2, 2)) * 2.f;
+        result = (quat) { s / 4.f, (R(0, 1) + R(1, 0)) / s, (R(0, 2) + R(2, 0)) / s, (R(2, 1) - R(1, 2)) / s };
+    } else if (R(1, 1) > R(2, 2)) {
+        float s = sqrtf(1.f + R(1, 1) - R(0, 0) - R(2, 2)) * 2.f;
+        result = (quat) { (R(0, 1) + R(1, 0)) / s, s / 4.f, (R(1, 2) + R(2, 1)) / s, (R(0, 2) - R(2, 0)) / s };
+    } else {
+        float s = sqrtf(1.f + R(2, 2) - R(0, 0) - R(1, 1)) * 2.f;
+        result = (quat) { (R(0, 2) + R(2, 0)) / s, (R(1, 2) + R(2, 1)) / s, s / 4.f, (R(1, 0) - R(0, 1)) / s };
+    }
+    
+    #undef R
+    return result;
+}
+
+static ship_orientation ship_orientation_find(s8 m[3][3]) {
+    for (int i = 0; i < SHIP_ORIENTATION_COUNT; i++) {
+        if (memcmp(ship_orientations[i].matrix, m, sizeof(ship_orientations[i].matrix)) == 0) { return i; }
+    }
+    
+    return SHIP_ORIENTATION_IDENTITY;
+}
+
+// @Info: snaps q to the closest of the orientations, used for rotations that were stored as quaternions
+static ship_orientation ship_orientation_from_quat(quat q) {
+    mat4 rotation = quat_to_mat(q);
+    
+    s8 m[3][3];
+    for (int c = 0; c < 3; c++) {
+        for (int r = 0; r < 3; r++) {
+            m[c][r] = (s8)floorf(rotation.elements[c][r] + 0.5f);
+        }
+    }
+    
+    return ship_orientation_find(m);
+}
+
+static void init_ship_orientations() {
+    // @Info: every orientation is a permutation of the axes with a sign for each axis, the ones with
+    //        a determinant of -1 would mirror the part and are skipped. The indices end up in the save files, 
+    //        so the order of these loops must not change. The identity comes first.
+    int permutations[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+    int parities[6] = { 1, -1, -1, 1, 1, -1 };
+    
+    int count = 0;
+    for (int p = 0; p < 6; p++) {
+        for (int signs = 0; signs < 8; signs++) {
+            int s[3] = { (signs & 1) ? -1 : 1, (signs & 2) ? -1 : 1, (signs & 4) ? -1 : 1 };
+            if (parities[p] * s[0] * s[1] * s[2] != 1) { continue; }
+            
+            ship_orientation_info* orientation = &ship_orientations[count++];
+            *orientation = (ship_orientation_info) { 0 };
+            
+            for (int axis = 0; axis < 3; axis++) {
+                orientation->matrix[axis][permutations[p][axis]] = s[axis];
+            }
+            
+            orientation->rotation = ship_orientation_matrix_to_quat(orientation->matrix);
+        }
+    }
+    
+    assert(count == SHIP_ORIENTATION_COUNT);
+    
+    for (int a = 0; a < SHIP_ORIENTATION_COUNT; a++) {
+        for (int b = 0; b < SHIP_ORIENTATION_COUNT; b++) {
+            s8 product[3][3] = { 0 };
+            
+            for (int c = 0; c < 3; c++) {
+                for (int r = 0; r < 3; r++) {
+                    for (int k = 0; k < 3; k++) {
+                        product[c][r] += ship_orientations[a].matrix[k][r] * ship_orientations[b].matrix[c][k];
+                    }
+                }
+            }
+            
+            ship_orientation_products[a][b] = ship_orientation_find(product);
+        }
+    }
+    
+    ship_orientation_turn_x = ship_orientation_from_quat(quat_from_axis_angle(vec3(1, 0, 0), DEG_TO_RAD(90)));
+    ship_orientation_turn_y = ship_orientation_from_quat(quat_from_axis_angle(vec3(0, 1, 0), DEG_TO_RAD(90)));
+}
+
+// === part graph
+ivec3 ship_graph_directions[6] = {
+    { 1, 0, 0 }, { -1,  0,  0 },
+    { 0, 1, 0 }, {  0, -1,  0 },
+    { 0, 0, 1 }, {  0,  0, -1 },
 };
 
-static inline vec3 collision_quad_get_center(collision_quad quad) {
-    return vec_add(quad.a, vec_mul(vec_sub(quad.b, quad.a), 0.5f));
+// @Note: directions are stored in pairs, so the opposite direction of d is d ^ 1
+#define ship_graph_opposite_direction(d) ((d) ^ 1)
+
+static inline ivec3 ship_part_cell(ship_part* part) {
+    return ivec3(part->x, part->y, part->z);
+}
+
+// @Info: parts keep their cell in s16s, so 16 bits per axis hold every cell a part can be in.
+//        0 is reserved for empty slots in the cell map.
+static inline u64 ship_graph_cell_key(ivec3 cell) {
+    u64 x = (u16)cell.x;
+    u64 y = (u16)cell.y;
+    u64 z = (u16)cell.z;
+    return ((x << 32) | (y << 16) | z) + 1;
+}
+
+static inline u32 ship_graph_cell_hash(u64 key) {
+    return (u32)((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static u32 ship_graph_find_cell(ship_graph* graph, ivec3 cell) {
+    u64 key = ship_graph_cell_key(cell);
+    u32 mask = graph->cell_map_size - 1;
+    
+    for (u32 i = ship_graph_cell_hash(key) & mask; graph->cell_keys[i]; i = (i + 1) & mask) {
+        if (graph->cell_keys[i] == key) { return graph->cell_parts[i]; }
+    }
+    
+    return SHIP_GRAPH_NO_PART;
+}
+
+static void ship_graph_insert_cell(ship_graph* graph, ivec3 cell, u32 part_index) {
+    u64 key = ship_graph_cell_key(cell);
+    u32 mask = graph->cell_map_size - 1;
+    
+    u32 i = ship_graph_cell_hash(key) & mask;
+    while (graph->cell_keys[i] && graph->cell_keys[i] != key) { i = (i + 1) & mask; }
+    
+    graph->cell_keys[i] = key;
+    graph->cell_parts[i] = part_index;
+}
+
+static void ship_graph_remove_cell(ship_graph* graph, ivec3 cell) {
+    u64 key = ship_graph_cell_key(cell);
+    u32 mask = graph->cell_map_size - 1;
+    
+    u32 i = ship_graph_cell_hash(key) & mask;
+    while (graph->cell_keys[i] != key) {
+        if (!graph->cell_keys[i]) { return; }
+        i = (i + 1) & mask;
+    }
+    
+    // @Info: backward shift deletion, so lookups never have to skip over tombstones.
+    //        Every entry after the hole that would still be found from its home slot is moved into it.
+    for (u32 j = (i + 1) & mask; graph->cell_keys[j]; j = (j + 1) & mask) {
+        u32 home = ship_graph_cell_hash(graph->cell_keys[j]) & mask;
+        
+        bool home_between = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (home_between) { continue; }
+        
+        graph->cell_keys[i] = graph->cell_keys[j];
+        graph->cell_parts[i] = graph->cell_parts[j];
+        i = j;
+    }
+    
+    graph->cell_keys[i] = 0;
+}
+
+static void ship_graph_clear(ship_graph* graph) {
+    memset(graph->neighbors, 0xFF, sizeof(graph->neighbors[0]) * graph->capacity);
+    memset(graph->cell_keys, 0, sizeof(graph->cell_keys[0]) * graph->cell_map_size);
+}
+
+static ship_graph make_ship_graph(memory_arena* arena, u32 capacity) {
+    ship_graph result = { .capacity = capacity };
+    
+    result.cell_map_size = 1;
+    while (result.cell_map_size < capacity * 2) { result.cell_map_size *= 2; }
+    
+    result.neighbors  = push_array(arena, ship_graph_neighbors, capacity);
+    result.cell_keys  = push_array(arena, u64, result.cell_map_size);
+    result.cell_parts = push_array(arena, u32, result.cell_map_size);
+    result.visited    = push_array_zero(arena, u32, capacity);
+    result.visited_by = push_array(arena, u8, capacity);
+    
+    for (int s = 0; s < SHIP_GRAPH_MAX_SEARCHES; s++) {
+        result.queues[s] = push_array(arena, u32, capacity);
+    }
+    
+    ship_graph_clear(&result);
+    return result;
+}
+
+static void ship_graph_add_part(ship_graph* graph, ivec3 cell, u32 part_index) {
+    assert(part_index < graph->capacity);
+    ship_graph_insert_cell(graph, cell, part_index);
+    
+    for (int d = 0; d < 6; d++) {
+        u32 neighbor = ship_graph_find_cell(graph, vec_add(cell, ship_graph_directions[d]));
+        graph->neighbors[part_index][d] = neighbor;
+        
+        if (neighbor != SHIP_GRAPH_NO_PART) {
+            graph->neighbors[neighbor][ship_graph_opposite_direction(d)] = part_index;
+        }
+    }
+}
+
+static void ship_graph_remove_part(ship_graph* graph, ivec3 cell, u32 part_index) {
+    for (int d = 0; d < 6; d++) {
+        u32 neighbor = graph->neighbors[part_index][d];
+        if (neighbor != SHIP_GRAPH_NO_PART) {
+            graph->neighbors[neighbor][ship_graph_opposite_direction(d)] = SHIP_GRAPH_NO_PART;
+        }
+        graph->neighbors[part_index][d] = SHIP_GRAPH_NO_PART;
+    }
+    
+    ship_graph_remove_cell(graph, cell);
+}
+
+static void ship_graph_rebuild(ship_graph* graph, ship_part* parts, u32 part_count) {
+    ship_graph_clear(graph);
+    
+    for (u32 i = 0; i < part_count; i++) {
+        if (parts[i].active) { ship_graph_add_part(graph, ship_part_cell(&parts[i]), i); }
+    }
+}
+
+static inline int ship_graph_find_search_root(int* parents, int s) {
+    while (parents[s] != s) { s = parents[s]; }
+    return s;
+}
+
+// @Info: returns how many pieces would be cut off from the rest of the ship if the given part was removed.
+//        Instead of walking the whole ship, one search is started from every neighbor of the part and 
+//        all of them are advanced in lockstep. Searches that run into each other are merged, and as soon
+//        as at most one of them is still running, all others have fully explored their piece. 
+//        That way the cost is bound by the size of the smaller pieces and not by the size of the ship.
+static int ship_graph_count_islands_without(ship_graph* graph, u32 part_index) {
+    u32 generation = ++graph->visit_generation;
+    
+    int parents[SHIP_GRAPH_MAX_SEARCHES];
+    u32 heads[SHIP_GRAPH_MAX_SEARCHES] = { 0 };
+    u32 tails[SHIP_GRAPH_MAX_SEARCHES] = { 0 };
+    int search_count = 0;
+    
+    // @Note: the removed part counts as visited, so no search walks through it
+    graph->visited[part_index] = generation;
+    graph->visited_by[part_index] = 0xFF;
+    
+    for (int d = 0; d < 6; d++) {
+        u32 neighbor = graph->neighbors[part_index][d];
+        if (neighbor == SHIP_GRAPH_NO_PART) { continue; }
+        
+        int s = search_count++;
+        parents[s] = s;
+        graph->queues[s][tails[s]++] = neighbor;
+        graph->visited[neighbor] = generation;
+        graph->visited_by[neighbor] = s;
+    }
+    
+    if (search_count <= 1) { return 0; }
+    
+    while (true) {
+        // @Info: count the pieces that are still being explored
+        bool root_running[SHIP_GRAPH_MAX_SEARCHES] = { 0 };
+        int running_count = 0;
+        for (int s = 0; s < search_count; s++) {
+            if (heads[s] == tails[s]) { continue; }
+            
+            int root = ship_graph_find_search_root(parents, s);
+            if (!root_running[root]) { running_count++; }
+            root_running[root] = true;
+        }
+        
+        if (running_count <= 1) { break; }
+        
+        for (int s = 0; s < search_count; s++) {
+            if (heads[s] == tails[s]) { continue; }
+            
+            u32 current = graph->queues[s][heads[s]++];
+            
+            for (int d = 0; d < 6; d++) {
+                u32 neighbor = graph->neighbors[current][d];
+                if (neighbor == SHIP_GRAPH_NO_PART) { continue; }
+                
+                if (graph->visited[neighbor] != generation) {
+                    graph->visited[neighbor] = generation;
+                    graph->visited_by[neighbor] = s;
+                    graph->queues[s][tails[s]++] = neighbor;
+                } else if (graph->visited_by[neighbor] != 0xFF) {
+                    int a = ship_graph_find_search_root(parents, s);
+                    int b = ship_graph_find_search_root(parents, graph->visited_by[neighbor]);
+                    if (a != b) { parents[b] = a; }
+                }
+            }
+        }
+    }
+    
+    // @Info: searches that never met are in separate pieces, one of them is what remains of the ship
+    int piece_count = 0;
+    for (int s = 0; s < search_count; s++) {
+        if (parents[s] == s) { piece_count++; }
+    }
+    
+    return piece_count - 1;
+}
+
+// === hull meshing
+static bool ship_part_get_block_extents(ship_part* part, s32 extents[3]) {
+    ship_part_type* type = &get_type(part);
+    if (!type->is_block) { return false; }
+    
+    // @Note: every row of the orientation matrix has exactly one non-zero entry, 
+    //        so world axis r gets the extent of the part axis that is rotated onto it
+    s8 (*m)[3] = ship_orientations[part->orientation].matrix;
+    for (int r = 0; r < 3; r++) {
+        float half_size = 0;
+        for (int c = 0; c < 3; c++) {
+            if (m[c][r]) { half_size = type->mesh.scale.elements[c] * 0.5f; }
+        }
+        
+        extents[r] = (s32)floorf(half_size * 1000.f + 0.5f);
+    }
+    
+    return true;
+}
+
+static int ship_hull_compare_rows(const void* _a, const void* _b) {
+    const ship_hull_face* a = _a;
+    const ship_hull_face* b = _b;
+    
+    if (a->direction != b->direction) { return a->direction - b->direction; }
+    if (a->plane     != b->plane)     { return a->plane < b->plane ? -1 : 1; }
+    if (a->extent_u  != b->extent_u)  { return a->extent_u - b->extent_u; }
+    if (a->extent_v  != b->extent_v)  { return a->extent_v - b->extent_v; }
+    if (a->v0        != b->v0)        { return a->v0 - b->v0; }
+    return a->u0 - b->u0;
+}
+
+static int ship_hull_compare_columns(const void* _a, const void* _b) {
+    const ship_hull_face* a = _a;
+    const ship_hull_face* b = _b;
+    
+    if (a->direction != b->direction) { return a->direction - b->direction; }
+    if (a->plane     != b->plane)     { return a->plane < b->plane ? -1 : 1; }
+    if (a->extent_u  != b->extent_u)  { return a->extent_u - b->extent_u; }
+    if (a->extent_v  != b->extent_v)  { return a->extent_v - b->extent_v; }
+    if (a->u0        != b->u0)        { return a->u0 - b->u0; }
+    if (a->u1        != b->u1)        { return a->u1 - b->u1; }
+    return a->v0 - b->v0;
+}
+
+static inline bool ship_hull_same_plane(ship_hull_face* a, ship_hull_face* b) {
+    return a->direction == b->direction && a->plane == b->plane 
+        && a->extent_u == b->extent_u && a->extent_v == b->extent_v;
+}
+
+// @Info: A face of a block is dropped when it lies on the cell boundary and the block in the neighboring
+//        cell covers it completely. The remaining faces are merged greedily: first into strips along u,
+//        then strips with the same u range are merged along v. Faces only merge along an axis if they
+//        span the full cell on it, otherwise there would be gaps between them.
+//
+//        The hull is rendered as a single object at the ship position, so coplanar seams between blocks
+//        do not show up in the outline pass, just like before when every block was drawn on its own.
+static void ship_hull_rebuild(ship_hull_info* hull, ship_info* ship, ship_graph* graph) {
+    arena_marker scratch = begin_scratch(0);
+    memory_arena* arena = scratch.arena;
+    
+    ship_hull_face* faces = push_array(arena, ship_hull_face, SHIP_PART_MAX_COUNT * 6);
+    int face_count = 0;
+    
+    for (int i = 0; i < SHIP_PART_MAX_COUNT; i++) {
+        ship_part* part = &ship->parts[i];
+        if (!part->active) { continue; }
+        
+        s32 extents[3];
+        if (!ship_part_get_block_extents(part, extents)) { continue; }
+        
+        ivec3 _cell = ship_part_cell(part);
+        s32 cell[3] = { _cell.x, _cell.y, _cell.z };
+        
+        for (int d = 0; d < 6; d++) {
+            int a = d / 2;
+            int u = (a + 1) % 3;
+            int v = (a + 2) % 3;
+            int sign = (d % 2 == 0) ? 1 : -1;
+            
+            u32 neighbor = graph->neighbors[i][d];
+            s32 neighbor_extents[3];
+            
+            if (extents[a] == 500 && neighbor != SHIP_GRAPH_NO_PART 
+                && ship_part_get_block_extents(&ship->parts[neighbor], neighbor_extents)
+                && neighbor_extents[a] == 500 
+                && neighbor_extents[u] >= extents[u] && neighbor_extents[v] >= extents[v]) {
+                continue;
+            }
+            
+            faces[face_count++] = (ship_hull_face) {
+                .direction = d,
+                .plane = cell[a] * 1000 + sign * extents[a],
+                .extent_u = extents[u], .extent_v = extents[v],
+                .u0 = cell[u], .u1 = cell[u],
+                .v0 = cell[v], .v1 = cell[v],
+            };
+        }
+    }
+    
+    qsort(faces, face_count, sizeof(faces[0]), ship_hull_compare_rows);
+    
+    int strip_count = 0;
+    for (int i = 0; i < face_count; i++) {
+        ship_hull_face* strip = strip_count ? &faces[strip_count - 1] : 0;
+        
+        bool extends_strip = strip && ship_hull_same_plane(strip, &faces[i]) 
+            && strip->extent_u == 500 && strip->v0 == faces[i].v0 && strip->u1 + 1 == faces[i].u0;
+        
+        if (extends_strip) { strip->u1 = faces[i].u1; }
+        else               { faces[strip_count++] = faces[i]; }
+    }
+    
+    qsort(faces, strip_count, sizeof(faces[0]), ship_hull_compare_columns);
+    
+    int quad_count = 0;
+    for (int i = 0; i < strip_count; i++) {
+        ship_hull_face* quad = quad_count ? &faces[quad_count - 1] : 0;
+        
+        bool extends_quad = quad && ship_hull_same_plane(quad, &faces[i]) 
+            && quad->extent_v == 500 && quad->u0 == faces[i].u0 && quad->u1 == faces[i].u1 
+            && quad->v1 + 1 == faces[i].v0;
+        
+        if (extends_quad) { quad->v1 = faces[i].v1; }
+        else              { faces[quad_count++] = faces[i]; }
+    }
+    
+    vertex* vertices = push_array(arena, vertex, quad_count * 4);
+    u32* indices     = push_array(arena, u32, quad_count * 6);
+    
+    for (int i = 0; i < quad_count; i++) {
+        ship_hull_face* quad = &faces[i];
+        
+        int a = quad->direction / 2;
+        int u = (a + 1) % 3;
+        int v = (a + 2) % 3;
+        
+        float plane = quad->plane / 1000.f;
+        float u_min = (quad->u0 * 1000 - quad->extent_u) / 1000.f;
+        float u_max = (quad->u1 * 1000 + quad->extent_u) / 1000.f;
+        float v_min = (quad->v0 * 1000 - quad->extent_v) / 1000.f;
+        float v_max = (quad->v1 * 1000 + quad->extent_v) / 1000.f;
+        
+        float corners[4][2] = { { u_min, v_min }, { u_max, v_min }, { u_max, v_max }, { u_min, v_max } };
+        
+        ivec3 direction = ship_graph_directions[quad->direction];
+        
+        for (int c = 0; c < 4; c++) {
+            vertex* vert = &vertices[i * 4 + c];
+            *vert = (vertex) { .normal = vec3(direction.x, direction.y, direction.z) };
+            
+            vert->p.elements[a] = plane;
+            vert->p.elements[u] = corners[c][0];
+            vert->p.elements[v] = corners[c][1];
+        }
+        
+        // @Note: the geometry shader derives the normal from the winding order, so faces pointing 
+        //        along the positive axis need the opposite winding of the ones pointing along the negative
+        u32 base = i * 4;
+        u32* index = &indices[i * 6];
+        if (quad->direction % 2 == 0) {
+            index[0] = base; index[1] = base + 2; index[2] = base + 1;
+            index[3] = base; index[4] = base + 3; index[5] = base + 2;
+        } else {
+            index[0] = base; index[1] = base + 1; index[2] = base + 2;
+            index[3] = base; index[4] = base + 2; index[5] = base + 3;
+        }
+    }
+    
+    if (hull->mesh.vao) { glDeleteVertexArrays(1, &hull->mesh.vao); }
+    
+    hull->mesh = (mesh) { .primitive = GL_TRIANGLES, 
+        .scale = vec3(1, 1, 1),
+        .rotation = unit_quat(),
+        .index_count = quad_count * 6
+    };
+    
+    if (quad_count) { hull->mesh.vao = make_vao(vertices, quad_count * 4, indices, quad_count * 6); }
+    
+    hull->dirty = false;
+    
+    end_scratch(scratch);
 }
 
 static inline void ship_clear(ship_info* ship) {
@@ -21,6 +501,54 @@ static inline void ship_clear(ship_info* ship) {
     ship->pos_t = 1.;
 }
 
+static ship_save_header make_ship_save_header(ship_info* ship) {
+    ship_save_header result = { 
+        .magic = SHIP_SAVE_MAGIC, 
+        .version = SHIP_SAVE_VERSION,
+        .part_count = ship->part_count,
+        .modified = (u64)time(0),
+    };
+    
+    bool first = true;
+    for (int i = 0; i < SHIP_PART_MAX_COUNT; i++) {
+        if (!ship->parts[i].active) { continue; }
+        ivec3 cell = ship_part_cell(&ship->parts[i]);
+        
+        if (first) {
+            result.bounds_min = result.bounds_max = cell;
+            first = false;
+        }
+        
+        result.bounds_min = ivec3(MIN(result.bounds_min.x, cell.x), MIN(result.bounds_min.y, cell.y), MIN(result.bounds_min.z, cell.z));
+        result.bounds_max = ivec3(MAX(result.bounds_max.x, cell.x), MAX(result.bounds_max.y, cell.y), MAX(result.bounds_max.z, cell.z));
+    }
+    
+    return result;
+}
+
+// @Info: the thumbnail looks down the y axis. The larger of the x and z extents is fit into it, 
+//        so the ship keeps its proportions. Higher parts are brighter. Needs the bounds of the header.
+static void make_ship_thumbnail(ship_save_header* header, ship_info* ship) {
+    memset(header->thumbnail, 0, sizeof(header->thumbnail));
+    if (!header->part_count) { return; }
+    
+    ivec3 extent = vec_add(vec_sub(header->bounds_max, header->bounds_min), ivec3(1, 1, 1));
+    int size = MAX(extent.x, extent.z);
+    int height_range = MAX(extent.y - 1, 1);
+    
+    for (int i = 0; i < SHIP_PART_MAX_COUNT; i++) {
+        if (!ship->parts[i].active) { continue; }
+        ivec3 cell = vec_sub(ship_part_cell(&ship->parts[i]), header->bounds_min);
+        
+        int x = cell.x * SHIP_THUMBNAIL_SIZE / size;
+        int y = cell.z * SHIP_THUMBNAIL_SIZE / size;
+        u8 value = 64 + cell.y * 191 / height_range;
+        
+        u8* pixel = &header->thumbnail[y * SHIP_THUMBNAIL_SIZE + x];
+        *pixel = MAX(*pixel, value);
+    }
+}
+
 static void save_ship(game_state* state, ship_info* ship) {
     ship_save_slot* slot = state->saves.current_slot;
     FILE* file = fopen(slot->path, "wb");
@@ -28,9 +556,44 @@ static void save_ship(game_state* state, ship_info* ship) {
         report("Could not open save file at %s for saving of slot %i\n", slot->path, slot->id); 
         return; 
     }    
+    
+    // @Note: the header keeps the old thumbnail for now, finish_ship_save_thumbnail redoes it on a later frame
+    ship_save_header header = make_ship_save_header(ship);
+    if (slot->has_header) { memcpy(header.thumbnail, slot->header.thumbnail, sizeof(header.thumbnail)); }
 
+    fwrite(&header, sizeof(header), 1, file);
     fwrite(ship, sizeof(*ship), 1, file);
     fclose(file);
+    
+    slot->header = header;
+    slot->has_header = true;
+    
+    state->saves.thumbnail_pending_slot = slot;
+}
+
+// @Info: makes the thumbnail of the last save and writes the header again, called at the start of the frame after 
+//        the save so that all the parts added in a frame cost one thumbnail. The ship has to still be the one of the slot.
+static void finish_ship_save_thumbnail(game_state* state, ship_info* ship) {
+    ship_save_slot* slot = state->saves.thumbnail_pending_slot;
+    if (!slot) { return; }
+    state->saves.thumbnail_pending_slot = 0;
+    
+    make_ship_thumbnail(&slot->header, ship);
+    
+    FILE* file = fopen(slot->path, "r+b");
+    if (!file) { 
+        report("Could not open save file at %s for the thumbnail of slot %i\n", slot->path, slot->id); 
+        return; 
+    }
+    
+    fwrite(&slot->header, sizeof(slot->header), 1, file);
+    fclose(file);
+    
+    // @Note: the thumbnail gets recreated the next time the slot is shown
+    if (slot->thumbnail_texture) {
+        glDeleteTextures(1, &slot->thumbnail_texture);
+        slot->thumbnail_texture = 0;
+    }
 }
 
 static void render_ship(ship_info* ship) {
@@ -41,20 +604,25 @@ static void render_ship(ship_info* ship) {
     }
     
     ship->position = vec_lerp(ship->position, ship->target_position, ship->pos_t);
+    
+    if (ship_hull.dirty) { ship_hull_rebuild(&ship_hull, ship, &part_graph); }
+    if (ship_hull.mesh.index_count) { render_mesh_basic(ship_hull.mesh, .translation = ship->position); }
 
     for (int i = 0; i < SHIP_PART_MAX_COUNT; i++) {
         ship_part part = ship->parts[i];
         if (!part.active) { continue; }
+        if (get_type(&part).is_block) { continue; }
 
-        vec3 translation = vec_add(ship->position, part.offset);
+        vec3 translation = vec_add(ship->position, vec3(part.x, part.y, part.z));
     
         render_mesh_basic(get_type(&part).mesh, 
             .translation = translation,
-            .rotation = part.rotation);
+            .rotation = ship_orientations[part.orientation].rotation);
     }
 }
 
-static void ship_add_part(ship_info* ship, vec3 position, quat rotation, ship_part_type_id type_id) {
+// @Note: cell is relative to the ship position
+static void ship_add_part(ship_info* ship, ivec3 cell, ship_orientation orientation, ship_part_type_id type_id) {
     ship_part* part = 0;
     for (int i = 0; i < SHIP_PART_MAX_COUNT; i++) {
         if (!ship->parts[i].active) {
@@ -65,25 +633,72 @@ static void ship_add_part(ship_info* ship, vec3 position, quat rotation, ship_pa
     
     if (!part) { return; }
     
+    // @Note: parts may not share a grid cell
+    if (ship_graph_find_cell(&part_graph, cell) != SHIP_GRAPH_NO_PART) { return; }
+    
     ship->part_count++;
     
+    part->x = cell.x;
+    part->y = cell.y;
+    part->z = cell.z;
     part->type_id = type_id;
+    part->orientation = orientation;
     part->active = true;
-    part->offset = vec_sub(position, ship->position);
-    part->rotation = rotation;
+    
+    ship_graph_add_part(&part_graph, cell, part - ship->parts);
+    ship_hull.dirty = true;
     
     save_ship(global, ship); 
 }
 
+static void ship_remove_part(ship_info* ship, ship_part* part) {
+    ship_graph_remove_part(&part_graph, ship_part_cell(part), part - ship->parts);
+    
+    part->active = false;
+    ship->part_count--;
+    
+    ship_hull.dirty = true;
+}
+
+static void ship_convert_from_v1(ship_info* ship, ship_info_v1* legacy) {
+    ship_clear(ship);
+    
+    ship->position        = legacy->position;
+    ship->target_position = legacy->target_position;
+    ship->pos_t           = legacy->pos_t;
+    
+    for (int i = 0; i < SHIP_PART_MAX_COUNT; i++) {
+        ship_part_v1* old = &legacy->parts[i];
+        if (!old->active) { continue; }
+        
+        ship_part* part = &ship->parts[i];
+        part->x = (s16)floorf(old->offset.x + 0.5f);
+        part->y = (s16)floorf(old->offset.y + 0.5f);
+        part->z = (s16)floorf(old->offset.z + 0.5f);
+        part->type_id = old->type_id;
+        part->orientation = ship_orientation_from_quat(old->rotation);
+        part->active = true;
+        
+        ship->part_count++;
+    }
+}
+
 static void load_ship(game_state* state, ship_info* ship) {
     ship_save_slot* slot = state->saves.current_slot;
+    
+    // @Note: a thumbnail still pending belongs to the ship that is about to be replaced, it is made from it now
+    finish_ship_save_thumbnail(state, ship);
+    
+    // @Note: the graph and the hull only change once there is a new ship, a slot that fails to open keeps the old one
     if (!slot->used) {
         ship_clear(ship);
+        ship_graph_clear(&part_graph);
+        ship_hull.dirty = true;
         
         save_ship(state, ship);
         slot->used = true;
         
-        ship_add_part(ship, ship->position, unit_quat(), PART_CUBE);
+        ship_add_part(ship, ivec3(0, 0, 0), SHIP_ORIENTATION_IDENTITY, PART_CUBE);
     } else {
         FILE* file = fopen(slot->path, "rb");
         if (!file) {
@@ -91,46 +706,84 @@ static void load_ship(game_state* state, ship_info* ship) {
             return;
         }
 
-        fread(ship, sizeof(*ship), 1, file);
+        // @Note: old saves don't have a header and start with the ship right away
+        ship_save_header header;
+        bool has_header = fread(&header, sizeof(header), 1, file) == 1 && header.magic == SHIP_SAVE_MAGIC;
+        if (!has_header) { fseek(file, 0, SEEK_SET); }
+        
+        // @Note: read onto the scratch arena first, a slot cut short must not leave half a ship behind
+        arena_marker scratch = begin_scratch(0);
+        bool complete;
+        
+        if (has_header && header.version >= 2) {
+            ship_info* loaded = push_struct(scratch.arena, ship_info);
+            complete = fread(loaded, 1, sizeof(*loaded), file) == sizeof(*loaded);
+            if (complete) { *ship = *loaded; }
+        } else {
+            ship_info_v1* legacy = push_array_zero(scratch.arena, ship_info_v1, 1);
+            complete = fread(legacy, 1, sizeof(*legacy), file) == sizeof(*legacy);
+            if (complete) { ship_convert_from_v1(ship, legacy); }
+        }
+        
+        end_scratch(scratch);
         fclose(file);
+        
+        // @Note: like an unused slot, the editor only adds parts onto existing ones so the ship needs its root part
+        if (!complete) {
+            report("Save file %s of slot %i is too short, the slot starts over with a single part\n", slot->path, slot->id);
+            ship_clear(ship);
+            ship_graph_clear(&part_graph);
+            ship_add_part(ship, ivec3(0, 0, 0), SHIP_ORIENTATION_IDENTITY, PART_CUBE);
+            return;
+        }
+        
+        ship_graph_rebuild(&part_graph, ship->parts, SHIP_PART_MAX_COUNT);
+        ship_hull.dirty = true;
     }
 }
 
 typedef struct {
     ship_part* part;
-    collision_quad quad;
+    vec3 normal; // of the face of the part that is under the mouse
     float distance;
 } part_at_mouse_result;
 
 static part_at_mouse_result get_part_at_mouse(ship_info* ship) {
     vec3 ray = ray_from_screen(global->mouse.position);
     
-    part_at_mouse_result result;
+    part_at_mouse_result result = { 0 };
     
-    result.distance = 100;
-    result.part = 0;
-    result.quad = (collision_quad) { 0 };
+    // @Info: every part is picked as a unit cube around its offset
+    float boxes_data[6][ray_box_batch_capacity(SHIP_PART_MAX_COUNT)];
+    ship_part* box_parts[SHIP_PART_MAX_COUNT];
+    
+    ray_box_batch boxes = {
+        .min_x = boxes_data[0], .min_y = boxes_data[1], .min_z = boxes_data[2],
+        .max_x = boxes_data[3], .max_y = boxes_data[4], .max_z = boxes_data[5],
+    };
     
     for (int part_id = 0; part_id < SHIP_PART_MAX_COUNT; part_id++) {
         ship_part* part = &ship->parts[part_id];
         if (!part->active) { continue; }
         
-        vec3 part_position = vec_add(part->offset, ship->position);
+        vec3 part_position = vec_add(vec3(part->x, part->y, part->z), ship->position);
         
-        for (int i = 0; i < array_count(cube_collision_quads); i++) {
-            collision_quad quad = cube_collision_quads[i];
-            
-            quad.a = vec_add(quad.a, part_position);
-            quad.b = vec_add(quad.b, part_position);
-            
-            float d = intersect_ray_quad(global->editor_camera.position, ray, quad);
-                        
-            if (d >= 0 && d < result.distance) { 
-                result.distance = d;
-                result.quad = quad;
-                result.part = part;
-            }
-        }
+        boxes.min_x[boxes.count] = part_position.x - .5f;
+        boxes.min_y[boxes.count] = part_position.y - .5f;
+        boxes.min_z[boxes.count] = part_position.z - .5f;
+        boxes.max_x[boxes.count] = part_position.x + .5f;
+        boxes.max_y[boxes.count] = part_position.y + .5f;
+        boxes.max_z[boxes.count] = part_position.z + .5f;
+        
+        box_parts[boxes.count++] = part;
+    }
+    
+    ray_box_hit hit = intersect_ray_boxes(global->editor_camera.position, ray, boxes, 100);
+    
+    result.distance = hit.distance;
+    if (hit.index >= 0) {
+        result.part = box_parts[hit.index];
+        result.normal = hit.normal;
     }
     
     return result;
@@ -146,24 +799,25 @@ static void update_and_render_part_preview(ship_info* ship, ship_part_type_id ty
     }
     
     global->current_part_rotation = quat_slerp(global->current_part_rotation,
-        global->part_rotation_t, global->current_part_rotation_target);
+        global->part_rotation_t, ship_orientations[global->current_part_orientation].rotation);
     
     if (get_result.part) {
-        vec3 quad_offset = vec_sub(collision_quad_get_center(get_result.quad), vec_add(get_result.part->offset, ship->position));
-        vec3 offset = vec_add(get_result.part->offset, vec_mul(quad_offset, 2.f)); 
+        ivec3 normal = ivec3((int)get_result.normal.x, (int)get_result.normal.y, (int)get_result.normal.z);
+        ivec3 cell = vec_add(ship_part_cell(get_result.part), normal);
         
-        vec3 position = vec_add(ship->position, offset);
+        vec3 part_position = vec_add(ship->position, vec3(get_result.part->x, get_result.part->y, get_result.part->z));
+        vec3 position = vec_add(ship->position, vec3(cell.x, cell.y, cell.z));
         
         // new part preview
         render_mesh_basic(part_types[type_id].mesh, .translation = position, .rotation = global->current_part_rotation,
             .color = (color)RGB(200, 100, 100), .normal_factor = 1.1);
         
         // box around the connecting part
-        render_mesh_basic(global->renderer.cube_mesh, .translation = vec_add(ship->position, get_result.part->offset), 
+        render_mesh_basic(global->renderer.cube_mesh, .translation = part_position, 
             .color = (color)RGBA(100, 100, 100, 120));
         
         if (global->mouse.left_down_this_frame) {
-            ship_add_part(ship, position, global->current_part_rotation_target, type_id);
+            ship_add_part(ship, cell, global->current_part_orientation, type_id);
         }
     }
 }
@@ -173,8 +827,13 @@ static void delete_part_at_mouse() {
     part_at_mouse_result get_result = get_part_at_mouse(&ship);
     
     if (get_result.part) {
-        get_result.part->active = false;
-        ship.part_count--;
+        int island_count = ship_graph_count_islands_without(&part_graph, get_result.part - ship.parts);
+        if (island_count) {
+            report("Can not delete this part, it would cut %i piece(s) off the ship\n", island_count);
+            return;
+        }
+        
+        ship_remove_part(&ship, get_result.part);
     }
     
     save_ship(global, &ship);
@@ -185,8 +844,8 @@ static void pick_part_type_at_mouse() {
     
     if (get_result.part) {
         global->current_part_type_id = get_result.part->type_id;
-        global->current_part_rotation = get_result.part->rotation;
-        global->current_part_rotation_target = get_result.part->rotation;
+        global->current_part_rotation = ship_orientations[get_result.part->orientation].rotation;
+        global->current_part_orientation = get_result.part->orientation;
     }
 }
 
@@ -202,10 +861,17 @@ static void init_ship_save_slots(game_state* state) {
         saves->slots[i].id = i;  
         saves->slots[i].path = to_c_str(buffer, push_permanent);
         
-        FILE* file = fopen(saves->slots[i].path, "rb");
-        saves->slots[i].used = (file != 0);
+        // @Info: only the header is mapped, the ship itself is not touched until the slot gets loaded
+        u64 mapped_size;
+        ship_save_header* header = platform_map_file(saves->slots[i].path, sizeof(ship_save_header), &mapped_size);
+        saves->slots[i].used = (header != 0);
         
-        if (file) { fclose(file); }
+        if (header && mapped_size == sizeof(*header) && header->magic == SHIP_SAVE_MAGIC) {
+            saves->slots[i].header = *header;
+            saves->slots[i].has_header = true;
+        }
+        
+        platform_unmap_file(header);
         
         string_clear(&buffer);
     }
@@ -213,6 +879,34 @@ static void init_ship_save_slots(game_state* state) {
     saves->current_slot = &saves->slots[0];
 }
 
+static u32 make_ship_thumbnail_texture(ship_save_header* header) {
+    u8 pixels[SHIP_THUMBNAIL_SIZE * SHIP_THUMBNAIL_SIZE * 4];
+    
+    for (int i = 0; i < SHIP_THUMBNAIL_SIZE * SHIP_THUMBNAIL_SIZE; i++) {
+        u8 value = header->thumbnail[i];
+        
+        pixels[i * 4 + 0] = 57  * value / 255;
+        pixels[i * 4 + 1] = 255 * value / 255;
+        pixels[i * 4 + 2] = 20  * value / 255;
+        pixels[i * 4 + 3] = value ? 255 : 0;
+    }
+    
+    u32 result;
+    glGenTextures(1, &result);
+    glBindTexture(GL_TEXTURE_2D, result);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SHIP_THUMBNAIL_SIZE, SHIP_THUMBNAIL_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    return result;
+}
+
 static void update_and_render_ship_saves_interface(game_state* state) {
     ship_saves_interface_info* saves = &state->saves;
     
@@ -268,6 +962,7 @@ static void update_and_render_ship_saves_interface(game_state* state) {
     int scissor_h = (slot_w + pad) * (MAX_SHIP_SAVE_SLOTS) + 6;
     scissor(slot_x - pad, scissor_y, slot_w + pad * 2, scissor_h);
     
+    bool created_thumbnail = false;
     for (int i = 0; i < MAX_SHIP_SAVE_SLOTS; i++) {
         ship_save_slot* slot = &saves->slots[i];
         
@@ -287,6 +982,22 @@ static void update_and_render_ship_saves_interface(game_state* state) {
         
         ui_quad(slot_x, slot_y, slot_w, slot_w, (color)RGB_GRAY(100));
         
+        if (slot->has_header) {
+            // @Info: thumbnails are created lazily, at most one per frame
+            if (!slot->thumbnail_texture && !created_thumbnail) {
+                slot->thumbnail_texture = make_ship_thumbnail_texture(&slot->header);
+                created_thumbnail = true;
+            }
+            
+            if (slot->thumbnail_texture) {
+                ui_quad_textured(slot_x, slot_y, slot_w, slot_w, slot->thumbnail_texture);
+            }
+            
+            string part_count = string_buffer(8);
+            string_write(&part_count, slot->header.part_count);
+            render_text(part_count, slot_x + 2, slot_y + slot_w - 10, .height = 8, .color = RGB_GRAY(200));
+        }
+        
         string buffer = string_buffer(8);
         string_write(&buffer, i);
         render_text(buffer, slot_x, slot_y, .height = 32, .color = RGB(57, 255, 20));
@@ -301,6 +1012,7 @@ static void init_ship_part_types(game_state* state) {
     part_types[PART_CUBE] = (ship_part_type) {
         .id = PART_CUBE,
         .mesh = make_cube_mesh(),
+        .is_block = true,
     };
     
     part_types[PART_THRUSTER] = (ship_part_type) {
@@ -415,6 +1127,7 @@ static void init_ship_part_types(game_state* state) {
     part_types[PART_BOARD] = (ship_part_type) {
         .id = PART_BOARD,
         .mesh = make_cube_mesh(),
+        .is_block = true,
     };
     part_types[PART_BOARD].mesh.scale = vec3(1, 0.2, 1);
     
@@ -38,21 +38,41 @@ typedef enum {
     PART_TYPE_COUNT
 } ship_part_type_id;
 
-typedef struct {
-    vec3 a, b;
-} collision_quad;
-
 typedef struct {
     ship_part_type_id id;
     mesh mesh;
+    
+    // @Info: blocks are axis-aligned boxes (the cube mesh scaled by mesh.scale). They are not rendered
+    //        one by one, but merged into the ship hull mesh, see ship_hull_rebuild()
+    bool is_block;
 } ship_part_type;
 
+#define SHIP_ORIENTATION_COUNT 24
+#define SHIP_ORIENTATION_IDENTITY 0
+
+// @Info: index into ship_orientations, one of the 24 rotations that map the axes onto the axes
+typedef u8 ship_orientation;
+
 typedef struct {
-    ship_part_type_id type_id;
-    bool active;
+    s8 matrix[3][3]; // @Note: column major like mat4, matrix[i] is where axis i ends up
+    quat rotation;   // @Note: the same rotation, for rendering and the preview animation
+} ship_orientation_info;
+
+ship_orientation_info ship_orientations[SHIP_ORIENTATION_COUNT];
+
+// @Info: ship_orientation_products[a][b] is the orientation of rotating by b first and then by a
+ship_orientation ship_orientation_products[SHIP_ORIENTATION_COUNT][SHIP_ORIENTATION_COUNT];
+
+// @Info: a quarter turn around the x and the y axis (KEY_R and KEY_T in the editor)
+ship_orientation ship_orientation_turn_x;
+ship_orientation ship_orientation_turn_y;
+
+typedef struct {
+    s16 x, y, z; // @Info: grid cell relative to the ship position
+    u8 type_id;  // @Info: ship_part_type_id
     
-    vec3 offset;
-    quat rotation;
+    u8 orientation : 5;
+    u8 active      : 1;
 } ship_part;
 
 typedef struct {
@@ -65,12 +85,99 @@ typedef struct {
 } ship_info;
 ship_info ship = { 0 };
 
+// @Info: the part and ship layout used by saves up to version 1, they get converted when loaded
+typedef struct {
+    ship_part_type_id type_id;
+    bool active;
+    
+    vec3 offset;
+    quat rotation;
+} ship_part_v1;
+
+typedef struct {
+    int part_count;
+    ship_part_v1 parts[SHIP_PART_MAX_COUNT];
+    
+    vec3 position;
+    vec3 target_position;
+    float pos_t;
+} ship_info_v1;
+
+#define SHIP_GRAPH_NO_PART 0xFFFFFFFF
+#define SHIP_GRAPH_MAX_SEARCHES 6
+
+typedef u32 ship_graph_neighbors[6];
+
+// @Info: face adjacency between the parts of the ship. This is not part of the save file, 
+//        it is rebuilt whenever a ship is loaded and kept up to date by ship_add_part/ship_remove_part.
+//        The arrays are made for a fixed number of parts by make_ship_graph, part indices go up to capacity.
+typedef struct {
+    u32 capacity;
+    ship_graph_neighbors* neighbors;
+    
+    // @Info: open addressing map from a packed grid cell to the index of the part occupying it,
+    //        cell_map_size is a power of two and at least twice the capacity
+    u32 cell_map_size;
+    u64* cell_keys;
+    u32* cell_parts;
+    
+    // @Info: scratch memory for ship_graph_count_islands_without()
+    u32 visit_generation;
+    u32* visited;
+    u8*  visited_by;
+    u32* queues[SHIP_GRAPH_MAX_SEARCHES];
+} ship_graph;
+ship_graph part_graph = { 0 };
+
+typedef struct {
+    u8 direction;
+    
+    // @Note: all of these are in thousandths of a cell, so faces can be compared exactly
+    s32 plane;
+    s32 extent_u, extent_v;
+    
+    // @Info: the range of cells the face covers along the two axes of its plane
+    s32 u0, u1;
+    s32 v0, v1;
+} ship_hull_face;
+
+typedef struct {
+    mesh mesh;
+    bool dirty;
+} ship_hull_info;
+ship_hull_info ship_hull = { 0 };
+
 ship_part_type part_types[PART_TYPE_COUNT];
 
+#define SHIP_SAVE_MAGIC 0x50494853 // "SHIP"
+#define SHIP_SAVE_VERSION 2 // @Info: 2 changed ship_part to grid cells and orientations
+#define SHIP_THUMBNAIL_SIZE 16
+
+// @Info: written in front of the ship_info in every save file, so the save interface can show
+//        something about a slot without loading the whole ship. Saves from before the header 
+//        existed start right with the ship_info and are still loaded.
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 part_count;
+    ivec3 bounds_min;
+    ivec3 bounds_max;
+    u64 modified; // @Info: seconds since the epoch
+    
+    // @Info: top-down height map of the ship, 0 means there is no part in that column
+    u8 thumbnail[SHIP_THUMBNAIL_SIZE * SHIP_THUMBNAIL_SIZE];
+} ship_save_header;
+
 typedef struct {
     int id;
     char* path;
     bool used;
+    
+    bool has_header;
+    ship_save_header header;
+    
+    // @Info: created the first time the slot is shown, 0 if it still needs to be (re)created
+    u32 thumbnail_texture;
 } ship_save_slot;
 
 #define MAX_SHIP_SAVE_SLOTS 8
@@ -78,6 +185,7 @@ typedef struct {
     bool is_open;
     ship_save_slot slots[MAX_SHIP_SAVE_SLOTS];
     ship_save_slot* current_slot;
+    ship_save_slot* thumbnail_pending_slot; // @Info: saved but its thumbnail is not made yet, see finish_ship_save_thumbnail
     
     float open_t;
     float target_t;
@@ -0,0 +1,368 @@
+#pragma once
+
+// @Info: A snapshot is the committed part of the permanent storage plus the few globals that live outside of it,
+//        written to a file. Loading maps the file back (copy on write) at the same address, so all the pointers
+//        in it stay valid. That only works with the fixed base address of DEV builds and for the same build.
+//
+//        GL objects do not survive this, the ids in the snapshot belong to the context it was taken in. The
+//        catalogs (shader names, texture paths), the framebuffer attachments and the meshes describe everything
+//        there is though: objects this session already has get reused, missing ones get loaded from their paths
+//        and the rest is deleted.
+//
+//        F5 writes a new snapshot_<n>.bin (they are never overwritten, a loaded one stays mapped),
+//        F9 loads the last one and the -resume command line argument starts from it.
+
+#define SNAPSHOT_MAGIC       0x50414E53 // "SNAP"
+#define SNAPSHOT_VERSION     1
+#define SNAPSHOT_DATA_OFFSET kilobytes(64) // @Note: mapped file offsets have to be multiples of 64K on windows
+#define SNAPSHOT_MAX_COUNT   9999
+
+typedef struct {
+    u32 magic;
+    u32 version;
+    char build[32];     // @Info: __DATE__ __TIME__, struct layouts only match within the same build
+    
+    u64 permanent_base;
+    u64 permanent_size; // @Info: the committed part, it follows the header at SNAPSHOT_DATA_OFFSET
+    u64 globals_size;   // @Info: snapshot_globals, after the permanent storage
+} snapshot_header;
+
+// @Info: game state that does not live in the permanent storage
+#define SNAPSHOT_GLOBAL(x) { &(x), sizeof(x) }
+static struct {
+    void* data;
+    u64 size;
+} snapshot_globals[] = {
+    SNAPSHOT_GLOBAL(ship),
+    SNAPSHOT_GLOBAL(part_graph),
+    SNAPSHOT_GLOBAL(ship_hull),
+    SNAPSHOT_GLOBAL(scroll_t),
+    SNAPSHOT_GLOBAL(scroll_to_add),
+};
+
+// @Info: what the current session owns and keeps when a snapshot gets loaded
+typedef struct {
+    platform_info* platform;
+    
+    memory_arena transient_arena;
+    memory_arena double_buffered_arenas[2];
+    u32 double_buffered_index;
+    
+    shader_catalog shaders;     // @Note: copied into transient memory
+    texture_catalog textures;
+    
+    renderer_info renderer;
+    u32 font_vao, font_vbo;
+    u32 thumbnails[MAX_SHIP_SAVE_SLOTS];
+    u32 hull_vao;
+#if MEMORY_TRACKING
+    memory_tracker* memory_tracker; // @Note: copied into transient memory, the one in the snapshot is of another session
+#endif
+} snapshot_live_state;
+
+static u64 get_snapshot_globals_size() {
+    u64 result = 0;
+    for (int i = 0; i < array_count(snapshot_globals); i++) { result += snapshot_globals[i].size; }
+    return result;
+}
+
+static void make_snapshot_header(snapshot_header* header, game_state* state) {
+    *header = (snapshot_header) {
+        .magic = SNAPSHOT_MAGIC,
+        .version = SNAPSHOT_VERSION,
+        .permanent_base = (u64)state->platform->permanent_storage,
+        .permanent_size = state->permanent_arena.committed,
+        .globals_size = get_snapshot_globals_size(),
+    };
+    
+    char* build = __DATE__ " " __TIME__;
+    memory_copy(header->build, build, c_string_length(build));
+}
+
+static char* get_snapshot_path(int index) {
+    string path = string_buffer(32);
+    string_write(&path, "snapshot_");
+    string_write(&path, index);
+    string_write(&path, ".bin");
+    return to_c_str(path, push_transient);
+}
+
+// @Info: 0 if there is none, numbering continues after the first gap
+static int get_last_snapshot_index() {
+    int result = 0;
+    
+    for (int i = 1; i <= SNAPSHOT_MAX_COUNT; i++) {
+        FILE* file = fopen(get_snapshot_path(i), "rb");
+        if (!file) { break; }
+        
+        fclose(file);
+        result = i;
+    }
+    
+    return result;
+}
+
+static void save_snapshot(game_state* state) {
+    int index = get_last_snapshot_index() + 1;
+    char* path = get_snapshot_path(index);
+    
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        report("Could not open %s for writing the snapshot\n", path);
+        return;
+    }
+    
+    snapshot_header header;
+    make_snapshot_header(&header, state);
+    
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fseek(file, SNAPSHOT_DATA_OFFSET, SEEK_SET) == 0;
+    ok = ok && fwrite(state->platform->permanent_storage, 1, header.permanent_size, file) == header.permanent_size;
+    
+    for (int i = 0; ok && i < array_count(snapshot_globals); i++) {
+        ok = fwrite(snapshot_globals[i].data, 1, snapshot_globals[i].size, file) == snapshot_globals[i].size;
+    }
+    
+    fclose(file);
+    
+    if (ok) { report("Wrote snapshot %s (%llu KB)\n", path, header.permanent_size / 1024); }
+    else    { report("Failed to write the snapshot %s\n", path); }
+}
+
+static string copy_to_transient(string str) {
+    string result = push_string(&global->transient_arena, str.length);
+    string_copy(&result, str);
+    return result;
+}
+
+static void keep_live_state(game_state* state, snapshot_live_state* live) {
+    live->platform = state->platform;
+    
+    live->double_buffered_arenas[0] = state->double_buffered_arenas[0];
+    live->double_buffered_arenas[1] = state->double_buffered_arenas[1];
+    live->double_buffered_index = state->double_buffered_index;
+    
+    live->shaders.count = state->shaders.count;
+    live->shaders.shaders = push_array(&state->transient_arena, shader_info, state->shaders.count);
+    for (u32 i = 0; i < state->shaders.count; i++) {
+        live->shaders.shaders[i] = state->shaders.shaders[i];
+        live->shaders.shaders[i].name = copy_to_transient(state->shaders.shaders[i].name);
+    }
+    
+    live->textures.count = state->textures.count;
+    live->textures.textures = push_array(&state->transient_arena, texture_info, state->textures.count);
+    for (u32 i = 0; i < state->textures.count; i++) {
+        live->textures.textures[i] = state->textures.textures[i];
+        live->textures.textures[i].path = copy_to_transient(state->textures.textures[i].path);
+    }
+    
+#if MEMORY_TRACKING
+    live->memory_tracker = push_struct(&state->transient_arena, memory_tracker);
+    *live->memory_tracker = *state->memory_tracker;
+#endif
+    
+    // @Note: after the pushes above, they have to survive the load
+    live->transient_arena = state->transient_arena;
+    
+    live->renderer = state->renderer;
+    live->font_vao = state->font.vao;
+    live->font_vbo = state->font.vbo;
+    
+    for (int i = 0; i < MAX_SHIP_SAVE_SLOTS; i++) { live->thumbnails[i] = state->saves.slots[i].thumbnail_texture; }
+    live->hull_vao = ship_hull.mesh.vao;
+}
+
+static void rebuild_gl_objects(game_state* state, snapshot_live_state* live) {
+    for (u32 i = 0; i < state->shaders.count; i++) {
+        shader_info* shader = &state->shaders.shaders[i];
+        shader->id = 0;
+        
+        for (u32 j = 0; j < live->shaders.count; j++) {
+            shader_info* live_shader = &live->shaders.shaders[j];
+            if (!live_shader->id || !string_compare(live_shader->name, shader->name)) { continue; }
+            
+            shader->id = live_shader->id;
+            live_shader->id = 0;
+            break;
+        }
+        
+        if (!shader->id) { shader->id = load_shader(read_file(shader->path, &state->transient_arena)); }
+    }
+    
+    for (u32 i = 0; i < state->textures.count; i++) {
+        texture_info* texture = &state->textures.textures[i];
+        texture->id = 0;
+        
+        for (u32 j = 0; j < live->textures.count; j++) {
+            texture_info* live_texture = &live->textures.textures[j];
+            if (!live_texture->id || !string_compare(live_texture->path, texture->path)) { continue; }
+            
+            texture->id = live_texture->id;
+            texture->w = live_texture->w;
+            texture->h = live_texture->h;
+            live_texture->id = 0;
+            break;
+        }
+        
+        if (!texture->id) { texture->id = load_texture(texture->path.data, &texture->w, &texture->h); }
+    }
+    
+    for (u32 i = 0; i < live->shaders.count; i++) {
+        if (live->shaders.shaders[i].id) { glDeleteProgram(live->shaders.shaders[i].id); }
+    }
+    for (u32 i = 0; i < live->textures.count; i++) {
+        if (live->textures.textures[i].id) { glDeleteTextures(1, &live->textures.textures[i].id); }
+    }
+    
+    // @Note: the meshes and the scene framebuffer do not depend on what is in the snapshot,
+    //        the ones of this session already fit the window
+    state->renderer = live->renderer;
+    state->font.vao = live->font_vao;
+    state->font.vbo = live->font_vbo;
+    
+    // @Info: both of these get recreated when they are needed next
+    for (int i = 0; i < MAX_SHIP_SAVE_SLOTS; i++) {
+        if (live->thumbnails[i]) { glDeleteTextures(1, &live->thumbnails[i]); }
+        state->saves.slots[i].thumbnail_texture = 0;
+    }
+    
+    if (live->hull_vao) { glDeleteVertexArrays(1, &live->hull_vao); }
+    ship_hull.mesh.vao = 0;
+    ship_hull.mesh.index_count = 0;
+    ship_hull.dirty = true;
+}
+
+// @Info: function pointers and anything else tied to the running code rather than to the game, also used when a
+//        game module gets reloaded (see hot_reload.c)
+static void fix_up_process_state(game_state* state) {
+    state->strings.allocator = push_permanent;
+    state->current_input_proc = editor_controls;
+    state->current_text_input = 0;
+    
+    state->ui.active = state->ui.hot = state->ui.hot_to_be = 0;
+    memset(state->keymap, 0, sizeof(state->keymap));
+    memset(&state->editor_camera.controls, 0, sizeof(state->editor_camera.controls));
+    
+    // @Note: the watches point at the catalog entries of the snapshot now, or at the callbacks of an old module
+    platform_clear_file_watches();
+    for (u32 i = 0; i < state->shaders.count; i++) {
+        platform_add_file_watch(state->shaders.shaders[i].path, reload_shader, &state->shaders.shaders[i]);
+    }
+    for (u32 i = 0; i < state->textures.count; i++) {
+        platform_add_file_watch(state->textures.textures[i].path, reload_texture, &state->textures.textures[i]);
+    }
+}
+
+// @Info: puts back the live parts of the state the snapshot overwrote
+static void fix_up_loaded_state(game_state* state, snapshot_live_state* live) {
+    global = state;
+    state->platform = live->platform;
+    
+    state->transient_arena = live->transient_arena;
+    state->double_buffered_arenas[0] = live->double_buffered_arenas[0];
+    state->double_buffered_arenas[1] = live->double_buffered_arenas[1];
+    state->double_buffered_index = live->double_buffered_index;
+#if MEMORY_TRACKING
+    *state->memory_tracker = *live->memory_tracker;
+    memory_tracking_use(state->memory_tracker);
+#endif
+    memory_tracking_replace_arena(&state->permanent_arena);
+    
+    state->snapshot_request = SNAPSHOT_REQUEST_NONE;
+    
+    fix_up_process_state(state);
+}
+
+static bool load_snapshot(game_state* state, char* path) {
+    platform_info* platform = state->platform;
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        report("Could not open the snapshot %s\n", path);
+        return false;
+    }
+    
+    snapshot_header header;
+    snapshot_header expected;
+    make_snapshot_header(&expected, state);
+    
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+        && header.magic == SNAPSHOT_MAGIC
+        && header.version == SNAPSHOT_VERSION;
+    
+    if (!valid) {
+        report("%s is not a snapshot\n", path);
+        fclose(file);
+        return false;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    u64 file_size = ftell(file);
+    
+    if (memcmp(header.build, expected.build, sizeof(header.build)) != 0
+        || header.permanent_base != expected.permanent_base
+        || header.globals_size != expected.globals_size
+        || header.permanent_size > platform->permanent_storage_size
+        || header.permanent_size < sizeof(game_state)
+        || file_size < SNAPSHOT_DATA_OFFSET + header.permanent_size + header.globals_size) {
+        report("The snapshot %s is from another build or got cut off\n", path);
+        fclose(file);
+        return false;
+    }
+    
+    snapshot_live_state live;
+    keep_live_state(state, &live);
+    
+    bool mapped = platform_map_file_into_reserved(path, SNAPSHOT_DATA_OFFSET, header.permanent_size,
+        platform->permanent_storage, platform->permanent_storage_size + MEMORY_GUARD_SIZE);
+    
+    bool ok = true;
+    if (!mapped) {
+        // @Note: the storage is only reserved again then, so it gets read in instead
+        report("Could not map the snapshot %s, reading it instead\n", path);
+        
+        ok = platform_commit_memory(platform->permanent_storage, header.permanent_size);
+        ok = ok && fseek(file, SNAPSHOT_DATA_OFFSET, SEEK_SET) == 0;
+        ok = ok && fread(platform->permanent_storage, 1, header.permanent_size, file) == header.permanent_size;
+    }
+    
+    ok = ok && fseek(file, SNAPSHOT_DATA_OFFSET + header.permanent_size, SEEK_SET) == 0;
+    for (int i = 0; ok && i < array_count(snapshot_globals); i++) {
+        ok = fread(snapshot_globals[i].data, 1, snapshot_globals[i].size, file) == snapshot_globals[i].size;
+    }
+    
+    fclose(file);
+    
+    // @Note: the old state is gone at this point, there is nothing to go back to
+    if (!ok) {
+        report("Failed to read the snapshot %s\n", path);
+        assert(false);
+        return false;
+    }
+    
+    fix_up_loaded_state(state, &live);
+    rebuild_gl_objects(state, &live);
+    
+    report("Loaded snapshot %s\n", path);
+    return true;
+}
+
+GAME_EXPORT bool game_load_last_snapshot(platform_info* platform) {
+    int index = get_last_snapshot_index();
+    if (!index) {
+        report("There is no snapshot to load\n");
+        return false;
+    }
+    
+    return load_snapshot(platform->permanent_storage, get_snapshot_path(index));
+}
+
+static void handle_snapshot_request(game_state* state) {
+    u8 request = state->snapshot_request;
+    state->snapshot_request = SNAPSHOT_REQUEST_NONE;
+    
+    switch (request) {
+        case SNAPSHOT_REQUEST_SAVE: { save_snapshot(state); } break;
+        case SNAPSHOT_REQUEST_LOAD: { game_load_last_snapshot(state->platform); } break;
+    }
+}
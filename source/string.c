@@ -1,5 +1,12 @@
 #pragma once
 
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
 typedef unsigned char bool;
 #define true 1
 #define false 0
@@ -100,7 +107,7 @@ static inline void string_increment_n(string* str, int n) {
 }
 
 static inline void string_eat_white_spaces(string* str) {
-    while (is_white_space(str->data[0])) { string_increment(str); }
+    while (str->length && is_white_space(str->data[0])) { string_increment(str); }
 }
 
 
@@ -144,26 +151,92 @@ char* to_c_str(string str, void* (*alloc)(size_t)) {
     return result;
 }
 
-int string_count_occurence(string str, char x) {
+// ===============
+// scanning
+// @Info: these compare 32 (AVX2) or 16 (SSE) bytes at a time and do the rest one by one, 
+//        they never read past data + length
+static inline int string_count_trailing_zeros(unsigned int x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+#else
+    int result = 0;
+    while (!(x & 1)) { x >>= 1; result++; }
+    return result;
+#endif
+}
+
+// @Info: index of the first c, or length if there is none
+static inline unsigned int string_find_char(char* data, unsigned int length, char c) {
+    unsigned int i = 0;
+    
+#if VECTOR_SIMD_AVX2
+    __m256i needle_wide = _mm256_set1_epi8(c);
+    for (; i + 32 <= length; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((__m256i*)(data + i));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle_wide));
+        if (mask) { return i + string_count_trailing_zeros(mask); }
+    }
+#endif
+    
+#if VECTOR_SIMD_SSE
+    __m128i needle = _mm_set1_epi8(c);
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128((__m128i*)(data + i));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask) { return i + string_count_trailing_zeros(mask); }
+    }
+#endif
+    
+    for (; i < length; i++) {
+        if (data[i] == c) { return i; }
+    }
+    
+    return length;
+}
+
+static inline int string_count_char(char* data, unsigned int length, char c) {
     int count = 0;
-    for (int i = 0; i < str.length; i++) { 
-        if(str.data[i] == x) { count++; }
+    unsigned int i = 0;
+    
+#if VECTOR_SIMD_SSE
+    __m128i needle = _mm_set1_epi8(c);
+    __m128i zero = _mm_setzero_si128();
+    
+    while (i + 16 <= length) {
+        // @Note: a match is -1 in its byte, so subtracting counts up per byte. 
+        //        Sum the bytes up before one of them can overflow.
+        __m128i byte_counts = zero;
+        for (int block = 0; block < 255 && i + 16 <= length; block++, i += 16) {
+            __m128i chunk = _mm_loadu_si128((__m128i*)(data + i));
+            byte_counts = _mm_sub_epi8(byte_counts, _mm_cmpeq_epi8(chunk, needle));
+        }
+        
+        __m128i sums = _mm_sad_epu8(byte_counts, zero);
+        count += _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
     }
+#endif
+    
+    for (; i < length; i++) {
+        if (data[i] == c) { count++; }
+    }
+    
     return count;
 }
 
+int string_count_occurence(string str, char x) {
+    return string_count_char(str.data, str.length, x);
+}
+
 // does not include c
 string string_eat_to_first(string* str, char c) {
     string result = { .data=str->data };
-    int length = str->length;
-    for (int i = 0; i < length; i++) {
-        if (str->data[0] == c) {
-            break;
-        }
-        
-        string_increment(str);
-        result.length++;    
-    }
+    result.length = string_find_char(str->data, str->length, c);
+    
+    string_increment_n(str, result.length);
     
     return result;
 }
@@ -175,13 +248,11 @@ static inline string string_peek_to_first(string str, char c) {
 // includes c
 string string_after_first(string str, char c) {
     string result = {0};
-    for (int i = 0; i < str.length; i++) {
-        if (str.data[i] == c) {
-            result.data = str.data + i;
-            result.length = str.length - i;
-            result.size = result.length;
-            break;
-        }
+    unsigned int i = string_find_char(str.data, str.length, c);
+    if (i < str.length) {
+        result.data = str.data + i;
+        result.length = str.length - i;
+        result.size = result.length;
     }
 
     return result;
@@ -190,13 +261,11 @@ string string_after_first(string str, char c) {
 // includes c
 string string_until_first(string str, char c) {
     string result = {0};
-    for (int i = 0; i < str.length; i++) {
-        if (str.data[i] == c) {
-            result.data = str.data;
-            result.length = i + 1; // include c
-            result.size = result.length;
-            break;
-        }
+    unsigned int i = string_find_char(str.data, str.length, c);
+    if (i < str.length) {
+        result.data = str.data;
+        result.length = i + 1; // include c
+        result.size = result.length;
     }
     return result;
 }
@@ -236,7 +305,7 @@ string get_file_name_from_path(string path) {
     if (start > 0) { start++; } // remove the '/'
 
     int end = start;
-    while (path.data[end] != '.' && end < path.length) { end++; }
+    while (path.data[end] != '.' && end < (int)path.length) { end++; }
 
     result.length = end - start;
     result.size = result.length;
@@ -304,15 +373,416 @@ static inline long long string_peek_int(string str, int base) {
     return string_eat_int(&str, base);
 }
 
+// @Info: float parsing. The digits are collected into a 64 bit mantissa w and a decimal exponent q (value = w * 10^q).
+//        If w and 10^q are both exact as doubles, a single multiplication or division is already correctly rounded.
+//        Otherwise the Eisel-Lemire algorithm (Lemire, "Number Parsing at a Gigabyte per Second") gets the result 
+//        from a 128 bit approximation of 5^q. When that can not decide the rounding, or q is outside the table, 
+//        we fall back to strtod on a copy of the number that leaves out the '.', strtod would read the radix 
+//        character of the locale.
+#define STRING_POWER_OF_FIVE_MIN -64
+#define STRING_POWER_OF_FIVE_MAX  64
+
+// @Info: 5^q normalized to 128 bits (high, low). Generated, negative powers are rounded up, positive ones truncated.
+static const unsigned long long string_powers_of_five[][2] = {
+    { 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL }, // 5^-64
+    { 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL }, // 5^-63
+    { 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL }, // 5^-62
+    { 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL }, // 5^-61
+    { 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL }, // 5^-60
+    { 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL }, // 5^-59
+    { 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL }, // 5^-58
+    { 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL }, // 5^-57
+    { 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL }, // 5^-56
+    { 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL }, // 5^-55
+    { 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL }, // 5^-54
+    { 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL }, // 5^-53
+    { 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL }, // 5^-52
+    { 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL }, // 5^-51
+    { 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL }, // 5^-50
+    { 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL }, // 5^-49
+    { 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL }, // 5^-48
+    { 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL }, // 5^-47
+    { 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL }, // 5^-46
+    { 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL }, // 5^-45
+    { 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL }, // 5^-44
+    { 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL }, // 5^-43
+    { 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL }, // 5^-42
+    { 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL }, // 5^-41
+    { 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL }, // 5^-40
+    { 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL }, // 5^-39
+    { 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL }, // 5^-38
+    { 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL }, // 5^-37
+    { 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL }, // 5^-36
+    { 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL }, // 5^-35
+    { 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL }, // 5^-34
+    { 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL }, // 5^-33
+    { 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL }, // 5^-32
+    { 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL }, // 5^-31
+    { 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL }, // 5^-30
+    { 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL }, // 5^-29
+    { 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL }, // 5^-28
+    { 0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL }, // 5^-27
+    { 0xC612062576589DDAULL, 0x95364AFE032A819EULL }, // 5^-26
+    { 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL }, // 5^-25
+    { 0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL }, // 5^-24
+    { 0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL }, // 5^-23
+    { 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL }, // 5^-22
+    { 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL }, // 5^-21
+    { 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL }, // 5^-20
+    { 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL }, // 5^-19
+    { 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL }, // 5^-18
+    { 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL }, // 5^-17
+    { 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL }, // 5^-16
+    { 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL }, // 5^-15
+    { 0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL }, // 5^-14
+    { 0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL }, // 5^-13
+    { 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL }, // 5^-12
+    { 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL }, // 5^-11
+    { 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL }, // 5^-10
+    { 0x89705F4136B4A597ULL, 0x31680A88F8953031ULL }, // 5^-9
+    { 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL }, // 5^-8
+    { 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL }, // 5^-7
+    { 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL }, // 5^-6
+    { 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL }, // 5^-5
+    { 0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL }, // 5^-4
+    { 0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL }, // 5^-3
+    { 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL }, // 5^-2
+    { 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL }, // 5^-1
+    { 0x8000000000000000ULL, 0x0000000000000000ULL }, // 5^0
+    { 0xA000000000000000ULL, 0x0000000000000000ULL }, // 5^1
+    { 0xC800000000000000ULL, 0x0000000000000000ULL }, // 5^2
+    { 0xFA00000000000000ULL, 0x0000000000000000ULL }, // 5^3
+    { 0x9C40000000000000ULL, 0x0000000000000000ULL }, // 5^4
+    { 0xC350000000000000ULL, 0x0000000000000000ULL }, // 5^5
+    { 0xF424000000000000ULL, 0x0000000000000000ULL }, // 5^6
+    { 0x9896800000000000ULL, 0x0000000000000000ULL }, // 5^7
+    { 0xBEBC200000000000ULL, 0x0000000000000000ULL }, // 5^8
+    { 0xEE6B280000000000ULL, 0x0000000000000000ULL }, // 5^9
+    { 0x9502F90000000000ULL, 0x0000000000000000ULL }, // 5^10
+    { 0xBA43B74000000000ULL, 0x0000000000000000ULL }, // 5^11
+    { 0xE8D4A51000000000ULL, 0x0000000000000000ULL }, // 5^12
+    { 0x9184E72A00000000ULL, 0x0000000000000000ULL }, // 5^13
+    { 0xB5E620F480000000ULL, 0x0000000000000000ULL }, // 5^14
+    { 0xE35FA931A0000000ULL, 0x0000000000000000ULL }, // 5^15
+    { 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL }, // 5^16
+    { 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL }, // 5^17
+    { 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL }, // 5^18
+    { 0x8AC7230489E80000ULL, 0x0000000000000000ULL }, // 5^19
+    { 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL }, // 5^20
+    { 0xD8D726B7177A8000ULL, 0x0000000000000000ULL }, // 5^21
+    { 0x878678326EAC9000ULL, 0x0000000000000000ULL }, // 5^22
+    { 0xA968163F0A57B400ULL, 0x0000000000000000ULL }, // 5^23
+    { 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL }, // 5^24
+    { 0x84595161401484A0ULL, 0x0000000000000000ULL }, // 5^25
+    { 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL }, // 5^26
+    { 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL }, // 5^27
+    { 0x813F3978F8940984ULL, 0x4000000000000000ULL }, // 5^28
+    { 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL }, // 5^29
+    { 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL }, // 5^30
+    { 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL }, // 5^31
+    { 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL }, // 5^32
+    { 0xC5371912364CE305ULL, 0x6C28000000000000ULL }, // 5^33
+    { 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL }, // 5^34
+    { 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL }, // 5^35
+    { 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL }, // 5^36
+    { 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL }, // 5^37
+    { 0x96769950B50D88F4ULL, 0x1314448000000000ULL }, // 5^38
+    { 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL }, // 5^39
+    { 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL }, // 5^40
+    { 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL }, // 5^41
+    { 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL }, // 5^42
+    { 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL }, // 5^43
+    { 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL }, // 5^44
+    { 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL }, // 5^45
+    { 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL }, // 5^46
+    { 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL }, // 5^47
+    { 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL }, // 5^48
+    { 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL }, // 5^49
+    { 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL }, // 5^50
+    { 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL }, // 5^51
+    { 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL }, // 5^52
+    { 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL }, // 5^53
+    { 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL }, // 5^54
+    { 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL }, // 5^55
+    { 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL }, // 5^56
+    { 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL }, // 5^57
+    { 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL }, // 5^58
+    { 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL }, // 5^59
+    { 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL }, // 5^60
+    { 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL }, // 5^61
+    { 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL }, // 5^62
+    { 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL }, // 5^63
+    { 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL }, // 5^64
+};
+
+static const double string_exact_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline unsigned long long string_multiply_128(unsigned long long a, unsigned long long b, unsigned long long* low) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *low = (unsigned long long)product;
+    return (unsigned long long)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long long high;
+    *low = _umul128(a, b, &high);
+    return high;
+#else
+    unsigned long long a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    unsigned long long b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    
+    unsigned long long lo_lo = a_lo * b_lo;
+    unsigned long long hi_lo = a_hi * b_lo;
+    unsigned long long lo_hi = a_lo * b_hi;
+    unsigned long long hi_hi = a_hi * b_hi;
+    
+    unsigned long long cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    
+    *low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return (hi_lo >> 32) + (cross >> 32) + hi_hi;
+#endif
+}
+
+static inline int string_count_leading_zeros(unsigned long long x) {
+    int result = 0;
+    if (!(x & 0xFFFFFFFF00000000ULL)) { result += 32; x <<= 32; }
+    if (!(x & 0xFFFF000000000000ULL)) { result += 16; x <<= 16; }
+    if (!(x & 0xFF00000000000000ULL)) { result +=  8; x <<=  8; }
+    if (!(x & 0xF000000000000000ULL)) { result +=  4; x <<=  4; }
+    if (!(x & 0xC000000000000000ULL)) { result +=  2; x <<=  2; }
+    if (!(x & 0x8000000000000000ULL)) { result +=  1; }
+    return result;
+}
+
+// @Note: w must not be 0 and q has to be in the table. Returns false if the result could not be decided.
+static bool string_eisel_lemire(unsigned long long w, int q, double* result) {
+    int leading_zeros = string_count_leading_zeros(w);
+    w <<= leading_zeros;
+    
+    const unsigned long long* power = string_powers_of_five[q - STRING_POWER_OF_FIVE_MIN];
+    
+    unsigned long long low;
+    unsigned long long high = string_multiply_128(w, power[0], &low);
+    
+    // @Note: the lower 9 bits of high are the ones that get shifted out below, 
+    //        only if they are all set the error of the approximation can matter
+    if ((high & 0x1FF) == 0x1FF) {
+        unsigned long long unused;
+        unsigned long long second = string_multiply_128(w, power[1], &unused);
+        low += second;
+        if (second > low) { high++; }
+        
+        if (low == 0xFFFFFFFFFFFFFFFFULL && (q < -27 || q > 55)) { return false; }
+    }
+    
+    int upper_bit = (int)(high >> 63);
+    unsigned long long mantissa = high >> (upper_bit + 9);
+    
+    // @Note: ((217706 * q) >> 16) is floor(log2(10^q)), 1023 is the exponent bias
+    int power_of_two = ((217706 * q) >> 16) + 63 + upper_bit - leading_zeros + 1023;
+    
+    // @Note: exactly halfway between two doubles, round to even
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1) {
+        if ((mantissa << (upper_bit + 9)) == high) { mantissa &= ~1ULL; }
+    }
+    
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    
+    if (mantissa >= (1ULL << 53)) {
+        mantissa = 1ULL << 52;
+        power_of_two++;
+    }
+    
+    mantissa &= ~(1ULL << 52);
+    
+    // @Note: can not happen for the exponents in the table, but subnormals and infinity are left to the slow path anyway
+    if (power_of_two <= 0 || power_of_two >= 0x7FF) { return false; }
+    
+    union { unsigned long long bits; double value; } convert = { .bits = mantissa | ((unsigned long long)power_of_two << 52) };
+    *result = convert.value;
+    
+    return true;
+}
+
+// @Info: whether data starts with word, ignoring the case of data. word has to be lower case.
+static inline bool string_match_word_lower_case(char* data, unsigned int length, char* word) {
+    unsigned int i = 0;
+    for (; word[i]; i++) {
+        if (i >= length || force_lower_case(data[i]) != word[i]) { return false; }
+    }
+    return true;
+}
+
+// @Info: reads at most str->length characters, the string does not need to be terminated. 
+//        Accepts the same decimal forms as strtod ([+-]digits[.digits][(e|E)[+-]digits], leading white space, inf, nan(chars))
+//        but no hex floats, and always uses '.' no matter the locale. If there is no number, nothing is eaten and 0 is returned.
 double string_eat_double(string* str) {
-    if (str->length == 0) { return 0; }
-    char* end;
+    char* data = str->data;
+    unsigned int length = str->length;
+    unsigned int i = 0;
     
-    // @Todo: This needs to go.
-    double result = strtod(str->data, &end);
+    while (i < length && (data[i] == ' ' || (data[i] >= '\t' && data[i] <= '\r'))) { i++; }
     
-    str->length = str->length - (end - str->data);
-    str->data = end;
+    bool is_negative = false;
+    if (i < length && (data[i] == '-' || data[i] == '+')) {
+        is_negative = data[i] == '-';
+        i++;
+    }
+    
+    unsigned int number_start = i;
+    
+    unsigned long long mantissa = 0;
+    int significant_digits = 0;
+    int exponent = 0;
+    int written_exponent = 0;   // @Info: only what comes after the 'e', for the strtod fallback
+    bool truncated = false;
+    bool any_digits = false;
+    
+    // @Note: only 19 significant digits fit into the mantissa, the rest only decide if it was truncated
+    while (i < length && is_num(data[i])) {
+        int digit = data[i] - '0';
+        if (significant_digits < 19) {
+            mantissa = mantissa * 10 + digit;
+            if (mantissa) { significant_digits++; }
+        } else {
+            exponent++;
+            if (digit) { truncated = true; }
+        }
+        
+        any_digits = true;
+        i++;
+    }
+    
+    if (i < length && data[i] == '.') {
+        i++;
+        
+        while (i < length && is_num(data[i])) {
+            int digit = data[i] - '0';
+            if (significant_digits < 19) {
+                mantissa = mantissa * 10 + digit;
+                exponent--;
+                if (mantissa) { significant_digits++; }
+            } else if (digit) {
+                truncated = true;
+            }
+            
+            any_digits = true;
+            i++;
+        }
+    }
+    
+    unsigned int digits_end = i;
+    double result = 0;
+    bool done = false;
+    
+    if (!any_digits) {
+        // @Note: inf, infinity, nan and nan(chars) in any case. The chars of a nan are skipped, it is always the same nan.
+        union { unsigned long long bits; double value; } special;
+        
+        if (i == number_start && string_match_word_lower_case(data + i, length - i, "inf")) {
+            i += string_match_word_lower_case(data + i, length - i, "infinity") ? 8 : 3;
+            special.bits = 0x7FF0000000000000ULL;
+        } else if (i == number_start && string_match_word_lower_case(data + i, length - i, "nan")) {
+            i += 3;
+            special.bits = 0x7FF8000000000000ULL;
+            
+            if (i < length && data[i] == '(') {
+                unsigned int j = i + 1;
+                while (j < length && (is_alphanum(data[j]) || data[j] == '_') && j - i < 64) { j++; }
+                if (j < length && data[j] == ')') { i = j + 1; }
+            }
+        } else {
+            return 0;
+        }
+        
+        result = special.value;
+        done = true;
+    } else if (i < length && force_lower_case(data[i]) == 'e') {
+        // @Note: the exponent only counts if it has digits, otherwise the 'e' is not part of the number
+        unsigned int j = i + 1;
+        bool exponent_is_negative = false;
+        
+        if (j < length && (data[j] == '-' || data[j] == '+')) {
+            exponent_is_negative = data[j] == '-';
+            j++;
+        }
+        
+        if (j < length && is_num(data[j])) {
+            int value = 0;
+            while (j < length && is_num(data[j])) {
+                if (value < 100000) { value = value * 10 + (data[j] - '0'); }
+                j++;
+            }
+            
+            written_exponent = exponent_is_negative ? -value : value;
+            exponent += written_exponent;
+            i = j;
+        }
+    }
+    
+    if (done) {
+        // @Note: inf or nan, the sign still gets applied below
+    } else if (mantissa == 0) {
+        result = 0;
+        done = true;
+    } else if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        result = (double)mantissa;
+        if (exponent < 0) { result /= string_exact_powers_of_ten[-exponent]; }
+        else              { result *= string_exact_powers_of_ten[ exponent]; }
+        done = true;
+    } else if (exponent >= STRING_POWER_OF_FIVE_MIN && exponent <= STRING_POWER_OF_FIVE_MAX) {
+        done = string_eisel_lemire(mantissa, exponent, &result);
+        
+        // @Note: the real mantissa is somewhere between mantissa and mantissa + 1, 
+        //        if both round to the same double that is the result
+        if (done && truncated) {
+            double upper;
+            done = string_eisel_lemire(mantissa + 1, exponent, &upper) && upper == result;
+        }
+    }
+    
+    if (!done) {
+        // @Note: all the digits and then an exponent that makes up for the ones after the '.', 
+        //        digits and an 'e' read the same in every locale
+        unsigned int digit_length = digits_end - number_start;
+        
+        char buffer[128];
+        char* copy = digit_length + 16 <= sizeof(buffer) ? buffer : malloc(digit_length + 16);
+        char* at = copy;
+        
+        int fraction_digits = 0;
+        bool in_fraction = false;
+        for (unsigned int c = number_start; c < digits_end; c++) {
+            if (data[c] == '.') { in_fraction = true; continue; }
+            *at++ = data[c];
+            fraction_digits += in_fraction;
+        }
+        
+        int copy_exponent = written_exponent - fraction_digits;
+        *at++ = 'e';
+        if (copy_exponent < 0) { *at++ = '-'; copy_exponent = -copy_exponent; }
+        
+        char exponent_digits[16];
+        int exponent_length = 0;
+        do {
+            exponent_digits[exponent_length++] = '0' + copy_exponent % 10;
+            copy_exponent /= 10;
+        } while (copy_exponent);
+        while (exponent_length) { *at++ = exponent_digits[--exponent_length]; }
+        *at = 0;
+        
+        result = strtod(copy, 0);
+        
+        if (copy != buffer) { free(copy); }
+    }
+    
+    if (is_negative) { result = -result; }
+    
+    str->data += i;
+    str->length -= i;
     
     return result;
 }
@@ -339,15 +809,11 @@ static inline string string_peek(string str, int count) {
 // result will not include the '\n'
 string string_eat_line(string* str) {
     string result = { .data=str->data };
+    result.length = string_find_char(str->data, str->length, '\n');
     
-    int max_length = str->length;
+    string_increment_n(str, result.length);
     
-    while (str->data[0] != '\n' && result.length < max_length) {
-        string_increment(str);
-        result.length++;
-    }
-    
-    if (str->data[0] == '\n') {
+    if (str->length && str->data[0] == '\n') {
         string_increment(str);
     }
     
@@ -367,16 +833,12 @@ string string_eat_token(string* str, char delimit) {
     }
 
     string result = { .data=str->data };
-    int length = str->length;
+    result.length = string_find_char(str->data, str->length, delimit);
     
-    for (int i = 0; i < length; i++) {
-        if (str->data[0] == delimit) {
-            string_increment(str); // remove delimiter
-            break;
-        }
-
-        string_increment(str);
-        result.length++;
+    string_increment_n(str, result.length);
+    
+    if (str->length) {
+        string_increment(str); // remove delimiter
     }
 
     result.size = result.length;
@@ -400,69 +862,124 @@ static inline unsigned long long string_read(string* str, int count) {
 
 // ===============
 // string write
+// @Note: for floats and doubles prec and base do not mean what they did before the Ryu writer, on purpose:
+//        - prec places are rounded half away from zero. They used to be cut off, 1.999999 with prec 5 was "1.99999"
+//          and is "2.00000" now, the closest value with 5 places.
+//        - a whole number gets all prec places, 1.0 was "1.0" and is "1.00000", like every other value.
+//        - base is ignored, floats are always decimal. Base 16 used to write the integer part and the fraction
+//          scaled by 10^prec in hex, which read back as neither.
+//        Integers still use base and minimum_digit_count the same way.
 typedef struct {
     int base;
-    int prec;       // decimal place count
+    int prec;       // decimal place count, STRING_WRITE_SHORTEST for the shortest digits that read back as the same value
     unsigned int minimum_digit_count;
 } string_write_args;
 
+#define STRING_WRITE_SHORTEST -1
+
 #define string_write(S, X, ...) _Generic((X), \
                                   char:             string_write_char,\
                                   unsigned char:    string_write_char,\
                                   int:              string_write_int,\
                                   unsigned int:     string_write_int,\
+                                  long:             string_write_int,\
+                                  unsigned long:    string_write_int,\
                                   long long:        string_write_int,\
                                   unsigned long long: string_write_int,\
                                   void*:            string_write_pointer,\
                                   char*:            string_write_c_string,\
                                   unsigned char*:   string_write_c_string,\
-                                  float:            string_write_double,\
+                                  float:            string_write_float,\
                                   double:           string_write_double,\
                                   string:           string_write_string)\
         (S, X, (string_write_args){.base = 10, .prec = 5, .minimum_digit_count = 0, __VA_ARGS__})
 
 const char* decimals = "0123456789ABCDEF";
+
+static const char string_digit_pairs[] = 
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static inline int string_decimal_length(unsigned long long x) {
+    int length = 1;
+    for (;;) {
+        if (x < 10)    { return length; }
+        if (x < 100)   { return length + 1; }
+        if (x < 1000)  { return length + 2; }
+        if (x < 10000) { return length + 3; }
+        x /= 10000;
+        length += 4;
+    }
+}
+
+// @Info: writes the decimal digits of x backwards, the last digit ends up right before end
+static inline void string_put_decimal(char* end, unsigned long long x) {
+    while (x >= 100) {
+        unsigned int pair = (unsigned int)(x % 100) * 2;
+        x /= 100;
+        *--end = string_digit_pairs[pair + 1];
+        *--end = string_digit_pairs[pair];
+    }
+    
+    if (x >= 10) {
+        unsigned int pair = (unsigned int)x * 2;
+        *--end = string_digit_pairs[pair + 1];
+        *--end = string_digit_pairs[pair];
+    } else {
+        *--end = (char)('0' + x);
+    }
+}
+
 int string_write_int(string* s, long long x, string_write_args args) {
     if (args.base < 2 || args.base > 16) return 0;
     
     bool is_negative = (x < 0);
-    x = ABS(x);
     
-    float log_x = (x == 0) ? 0 : log(x);
-    int digit_count = FLOOR(log_x / log(args.base)) + 1;
+    // @Note: negate in unsigned, -LLONG_MIN does not fit into a long long
+    unsigned long long magnitude = is_negative ? 0ULL - (unsigned long long)x : (unsigned long long)x;
+    
+    int digit_count = 1;
+    if (args.base == 10) {
+        digit_count = string_decimal_length(magnitude);
+    } else {
+        for (unsigned long long rest = magnitude / args.base; rest; rest /= args.base) { digit_count++; }
+    }
     
     int padding_zero_count = MAX(0, (int)args.minimum_digit_count - digit_count);
-
-    digit_count += padding_zero_count;
-
-    if (is_negative) { digit_count++; }
+    int length = is_negative + padding_zero_count + digit_count;
     
     // check for sufficient space
-    if (s->size - s->length < digit_count) return 0;
+    if (s->size - s->length < (unsigned int)length) return 0;
     
-    int index = digit_count;
     char* buffer = s->data + s->length;
     
+    if (is_negative) { *buffer++ = '-'; }
+    
     for (int i = 0; i < padding_zero_count; i++) {
-        buffer[i] = '0';
+        *buffer++ = '0';
     }
     
-    if (x == 0) { 
-        buffer[--index] = decimals[0];
+    if (args.base == 10) {
+        string_put_decimal(buffer + digit_count, magnitude);
     } else {
-        while(x) {
-            int d = x % args.base;
-            x = x / args.base;
-            
-            buffer[--index] = decimals[d];
-        }
+        char* end = buffer + digit_count;
+        do {
+            *--end = decimals[magnitude % args.base];
+            magnitude /= args.base;
+        } while (magnitude);
     }
     
-    if (is_negative) { buffer[0] = '-'; }
-    
-    s->length += digit_count;
+    s->length += length;
     
-    return digit_count;
+    return length;
 }
 
 int string_write_pointer(string* s, void* p, string_write_args args) {
@@ -481,7 +998,7 @@ int string_write_pointer(string* s, void* p, string_write_args args) {
 
 int string_write_c_string(string* s, char* c, string_write_args args) {
     int length = c_string_length(c);
-    if (s->size - s->length < length) { return 0; }
+    if (s->size - s->length < (unsigned int)length) { return 0; }
     
     memory_copy(s->data + s->length, c, length);
     s->length += length;
@@ -497,32 +1014,416 @@ int string_write_char(string* s, char c, string_write_args args) {
     return 1;
 }
 
-int string_write_double(string* s, double x, string_write_args args) {
-    // @Todo check for sufficient space
-    int ipart = (int)x;
-    double fpart = ABS(x - ipart);
+// @Info: shortest decimal that reads back as the same binary value, see Adams, "Ryu: Fast Float-to-String Conversion".
+//        This is the small table variant: the 128 bit multipliers for 5^i and 2^k/5^i are built from every 26th 
+//        power and a 2 bit correction per power, so the whole double range needs 28 table rows instead of 668.
+#define STRING_RYU_POW5_BITCOUNT     125
+#define STRING_RYU_POW5_INV_BITCOUNT 125
+#define STRING_RYU_POW5_TABLE_SIZE   26
+
+static const unsigned long long string_ryu_small_powers_of_five[STRING_RYU_POW5_TABLE_SIZE] = {
+    1ULL, 5ULL, 25ULL, 125ULL,
+    625ULL, 3125ULL, 15625ULL, 78125ULL,
+    390625ULL, 1953125ULL, 9765625ULL, 48828125ULL,
+    244140625ULL, 1220703125ULL, 6103515625ULL, 30517578125ULL,
+    152587890625ULL, 762939453125ULL, 3814697265625ULL, 19073486328125ULL,
+    95367431640625ULL, 476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL,
+    59604644775390625ULL, 298023223876953125ULL
+};
+
+// @Info: 5^i normalized to 125 bits (low, high). Generated.
+static const unsigned long long string_ryu_pow5_split[][2] = {
+    { 0x0000000000000000ULL, 0x1000000000000000ULL }, // 5^0
+    { 0x0000000000000000ULL, 0x14ADF4B7320334B9ULL }, // 5^26
+    { 0x0E549208B31ADB10ULL, 0x1ABA4714957D300DULL }, // 5^52
+    { 0x6DC6AD264D8F0866ULL, 0x1145B7E285BF98F5ULL }, // 5^78
+    { 0xEB1DBD923D8596CAULL, 0x1652EFDC6018A1FCULL }, // 5^104
+    { 0xB4C1B80B22AE923CULL, 0x1CDA62055B2D9D83ULL }, // 5^130
+    { 0x5BB28B4E8F7E4C30ULL, 0x12A5568B9F52F416ULL }, // 5^156
+    { 0xF08AED437682D4FBULL, 0x1819651531F9E78FULL }, // 5^182
+    { 0xB4EE134AD99BF150ULL, 0x1F25C186A6F04C28ULL }, // 5^208
+    { 0x16499ECB70C25F03ULL, 0x1420EB449C8842E6ULL }, // 5^234
+    { 0x85A56EAD360865B0ULL, 0x1A03FDE214CAF085ULL }, // 5^260
+    { 0x093DB1D57999890BULL, 0x10CFEB353A97DAD8ULL }, // 5^286
+    { 0xCF38BB735E3F36ACULL, 0x15BAAF44FA52673EULL }, // 5^312
+};
+
+// @Info: floor(2^k / 5^i) + 1 normalized to 125 bits (low, high). Generated.
+static const unsigned long long string_ryu_pow5_inv_split[][2] = {
+    { 0x0000000000000001ULL, 0x2000000000000000ULL }, // 5^-0
+    { 0x52A6C95FC0655034ULL, 0x18C240C4AECB13BBULL }, // 5^-26
+    { 0x7CA8D50071DFC806ULL, 0x1327FC58DA0F6FF5ULL }, // 5^-52
+    { 0x6520247D3556476EULL, 0x1DA48CE468E7C702ULL }, // 5^-78
+    { 0x6139CDD76802E6E9ULL, 0x16EF5B40C2FC7779ULL }, // 5^-104
+    { 0xF951A7FF43DE8C79ULL, 0x11BEBDF578B2F391ULL }, // 5^-130
+    { 0x7BE8BEE8D6E957E8ULL, 0x1B758D848FAC54B0ULL }, // 5^-156
+    { 0x8BD3F9E999A423EAULL, 0x153EDA614071A3B7ULL }, // 5^-182
+    { 0x0848F973CB3EE3CEULL, 0x10701BD527B4978CULL }, // 5^-208
+    { 0x153285EBB9EFBFA2ULL, 0x196FBB9BB44DB44DULL }, // 5^-234
+    { 0xADEEE7F86C07B696ULL, 0x13AE3591F5B4D936ULL }, // 5^-260
+    { 0x4D686A4EAF182222ULL, 0x1E74404F3DAADA91ULL }, // 5^-286
+    { 0x98C0A106E09EBD9FULL, 0x17900EA4FDA7C257ULL }, // 5^-312
+    { 0x8F20E37371497D0EULL, 0x123B140576D820B2ULL }, // 5^-338
+    { 0xB043138134743D85ULL, 0x1C35F4275F7A29ADULL }, // 5^-364
+};
+
+// @Info: the 2 bit corrections, 16 powers per entry. Generated.
+static const unsigned int string_ryu_pow5_offsets[] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x40000000, 0x59695995, 0x55545555, 
+    0x56555515, 0x41150504, 0x40555410, 0x44555145, 0x44504540, 0x45555550, 0x40004000, 
+    0x96440440, 0x55565565, 0x54454045, 0x40154151, 0x55559155, 0x51405555, 0x00000105
+};
+
+static const unsigned int string_ryu_pow5_inv_offsets[] = {
+    0x54544554, 0x04055545, 0x10041000, 0x00400414, 0x40010000, 0x41155555, 0x00000454, 0x00010044, 
+    0x40000000, 0x44000041, 0x50454450, 0x55550054, 0x51655554, 0x40004000, 0x01000001, 0x00010500, 
+    0x51515411, 0x05555554, 0x50411500, 0x40040000, 0x05040110, 0x00000000
+};
+
+// @Note: ceil(log2(5^e)) for e in [0, 3528], floor(log10(2^e)) for e in [0, 1650], floor(log10(5^e)) for e in [0, 2620]
+static inline int string_pow5_bits(int e)  { return (int)(((unsigned int)e * 1217359) >> 19) + 1; }
+static inline int string_log10_pow2(int e) { return (int)(((unsigned int)e * 78913) >> 18); }
+static inline int string_log10_pow5(int e) { return (int)(((unsigned int)e * 732923) >> 20); }
+
+static inline bool string_is_multiple_of_pow5(unsigned long long x, int p) {
+    int count = 0;
+    while (x % 5 == 0) {
+        x /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+// @Note: 0 < distance < 64
+static inline unsigned long long string_shift_right_128(unsigned long long low, unsigned long long high, int distance) {
+    return (high << (64 - distance)) | (low >> distance);
+}
+
+static inline void string_ryu_pow5(int i, unsigned long long* result) {
+    int base = i / STRING_RYU_POW5_TABLE_SIZE;
+    int base_power = base * STRING_RYU_POW5_TABLE_SIZE;
+    int offset = i - base_power;
     
-    // print the '-' instead of in string_write_int() to cover -0
-    if (x < 0) {
-        s->data[s->length++] = '-';
+    const unsigned long long* mul = string_ryu_pow5_split[base];
+    if (offset == 0) {
+        result[0] = mul[0];
+        result[1] = mul[1];
+        return;
     }
     
-    int written = string_write_int(s, ABS(ipart), args);
+    unsigned long long m = string_ryu_small_powers_of_five[offset];
+    unsigned long long low0, low1;
+    unsigned long long high1 = string_multiply_128(m, mul[1], &low1);
+    unsigned long long high0 = string_multiply_128(m, mul[0], &low0);
+    unsigned long long sum = high0 + low1;
+    if (sum < high0) { high1++; }
     
-    if (!written) { return 0; }
+    int delta = string_pow5_bits(i) - string_pow5_bits(base_power);
+    result[0] = string_shift_right_128(low0, sum, delta) + ((string_ryu_pow5_offsets[i / 16] >> ((i % 16) * 2)) & 3);
+    result[1] = string_shift_right_128(sum, high1, delta);
+}
 
-    if (args.prec) {
-        string_write_char(s, '.', args);
-        written += args.prec;
+static inline void string_ryu_pow5_inv(int i, unsigned long long* result) {
+    int base = (i + STRING_RYU_POW5_TABLE_SIZE - 1) / STRING_RYU_POW5_TABLE_SIZE;
+    int base_power = base * STRING_RYU_POW5_TABLE_SIZE;
+    int offset = base_power - i;
+    
+    const unsigned long long* mul = string_ryu_pow5_inv_split[base];
+    if (offset == 0) {
+        result[0] = mul[0];
+        result[1] = mul[1];
+        return;
+    }
+    
+    unsigned long long m = string_ryu_small_powers_of_five[offset];
+    unsigned long long low0, low1;
+    unsigned long long high1 = string_multiply_128(m, mul[1], &low1);
+    unsigned long long high0 = string_multiply_128(m, mul[0] - 1, &low0);
+    unsigned long long sum = high0 + low1;
+    if (sum < high0) { high1++; }
+    
+    int delta = string_pow5_bits(base_power) - string_pow5_bits(i);
+    result[0] = string_shift_right_128(low0, sum, delta) + 1 + ((string_ryu_pow5_inv_offsets[i / 16] >> ((i % 16) * 2)) & 3);
+    result[1] = string_shift_right_128(sum, high1, delta);
+}
+
+static inline unsigned long long string_ryu_mul_shift(unsigned long long m, const unsigned long long* mul, int j) {
+    unsigned long long low0, low1;
+    unsigned long long high1 = string_multiply_128(m, mul[1], &low1);
+    unsigned long long high0 = string_multiply_128(m, mul[0], &low0);
+    unsigned long long sum = high0 + low1;
+    if (sum < high0) { high1++; }
+    
+    return string_shift_right_128(sum, high1, j - 64);
+}
+
+typedef struct {
+    unsigned long long mantissa;
+    int exponent;   // the value is mantissa * 10^exponent
+} string_decimal;
+
+// @Info: m2 * 2^e2 is the (non zero) binary value with two extra bits, so that the halfway points to the neighbouring 
+//        values are integers as well. mm_shift is false when the lower neighbour is closer (m2 is a power of two).
+//        Works for any m2 below 2^54, so doubles and floats share it.
+static string_decimal string_shortest_decimal(unsigned long long m2, int e2, bool mm_shift) {
+    bool accept_bounds = (m2 & 1) == 0;
+    
+    unsigned long long mv = 4 * m2;
+    
+    // @Note: vr, vp and vm are the value and the upper and lower halfway points, scaled to decimal
+    unsigned long long vr, vp, vm;
+    int e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    
+    if (e2 >= 0) {
+        int q = string_log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        int k = STRING_RYU_POW5_INV_BITCOUNT + string_pow5_bits(q) - 1;
+        int i = -e2 + q + k;
+        
+        unsigned long long pow5[2];
+        string_ryu_pow5_inv(q, pow5);
+        vr = string_ryu_mul_shift(mv, pow5, i);
+        vp = string_ryu_mul_shift(mv + 2, pow5, i);
+        vm = string_ryu_mul_shift(mv - 1 - mm_shift, pow5, i);
+        
+        if (q <= 21) {
+            // @Note: only one of mv, mp and mm can be a multiple of 5
+            if (mv % 5 == 0) {
+                vr_is_trailing_zeros = string_is_multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_is_trailing_zeros = string_is_multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= string_is_multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        int q = string_log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = string_pow5_bits(i) - STRING_RYU_POW5_BITCOUNT;
+        int j = q - k;
+        
+        unsigned long long pow5[2];
+        string_ryu_pow5(i, pow5);
+        vr = string_ryu_mul_shift(mv, pow5, j);
+        vp = string_ryu_mul_shift(mv + 2, pow5, j);
+        vm = string_ryu_mul_shift(mv - 1 - mm_shift, pow5, j);
+        
+        if (q <= 1) {
+            // @Note: mv has at least two trailing zero bits, mp at least one, mm one only if mm_shift is set
+            vr_is_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_is_trailing_zeros = mm_shift;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_is_trailing_zeros = (mv & ((1ULL << q) - 1)) == 0;
+        }
+    }
+    
+    // find the shortest representation in the interval
+    int removed = 0;
+    unsigned long long output;
+    
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        // @Note: rare general case, the exact value or the lower bound end in zeros
+        int last_removed_digit = 0;
+        
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (int)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (int)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        
+        // exactly halfway, round to even
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            last_removed_digit = 4;
+        }
+        
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        bool round_up = false;
         
-        fpart *= pow(10, args.prec); // @Todo get rid of this pow call
+        // @Speed: usually at least two digits go, remove them in one step
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
         
-        if (fpart != 0) { args.minimum_digit_count = args.prec; }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
         
-        string_write_int(s, fpart, args);
+        output = vr + (vr == vm || round_up);
     }
+    
+    return (string_decimal){ .mantissa = output, .exponent = e10 + removed };
+}
 
-    return written;
+static const unsigned long long string_powers_of_ten[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL, 
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 
+    10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// @Info: prec >= 0 writes exactly prec decimal places, rounded half away from zero from the shortest digits, so 1.005
+//        gives "1.01" where printf (rounding the exact binary value 1.00499999...) gives "1.00". 
+//        A negative prec writes the shortest digits, switching to scientific notation outside of [1e-6, 1e21).
+//        minimum_digit_count pads the integer part, base is ignored.
+static int string_write_decimal(string* s, bool is_negative, string_decimal decimal, string_write_args args) {
+    unsigned long long mantissa = decimal.mantissa;
+    int exponent = decimal.exponent;
+    
+    if (args.prec >= 0) {
+        int dropped = -args.prec - exponent;
+        if (dropped > 19) {
+            mantissa = 0;
+            exponent = -args.prec;
+        } else if (dropped > 0) {
+            unsigned long long power = string_powers_of_ten[dropped];
+            unsigned long long rest = mantissa % power;
+            mantissa = mantissa / power + (rest >= power - rest);
+            exponent = -args.prec;
+        }
+    }
+    
+    char digits[20];
+    int digit_count = string_decimal_length(mantissa);
+    string_put_decimal(digits + digit_count, mantissa);
+    
+    // @Note: number of digits in front of the decimal point, can be negative or beyond the digits we have
+    int point = digit_count + exponent;
+    if (mantissa == 0) { point = 1; }
+    
+    bool scientific = args.prec < 0 && (point < -5 || point > 21);
+    
+    int length = is_negative;
+    int integer_length = 0, padding_zero_count = 0, fraction_length = 0;
+    int exponent_digit_count = 0;
+    
+    if (scientific) {
+        length += digit_count + (digit_count > 1) + 1 + (point - 1 < 0);
+        exponent_digit_count = string_decimal_length(ABS(point - 1));
+        length += exponent_digit_count;
+    } else {
+        integer_length = MAX(1, point);
+        padding_zero_count = MAX(0, (int)args.minimum_digit_count - integer_length);
+        fraction_length = (args.prec >= 0) ? args.prec : MAX(0, digit_count - point);
+        length += padding_zero_count + integer_length + (fraction_length > 0) + fraction_length;
+    }
+    
+    // check for sufficient space
+    if (s->size - s->length < (unsigned int)length) { return 0; }
+    
+    char* buffer = s->data + s->length;
+    
+    if (is_negative) { *buffer++ = '-'; }
+    
+    if (scientific) {
+        *buffer++ = digits[0];
+        if (digit_count > 1) {
+            *buffer++ = '.';
+            memory_copy(buffer, digits + 1, digit_count - 1);
+            buffer += digit_count - 1;
+        }
+        
+        *buffer++ = 'e';
+        if (point - 1 < 0) { *buffer++ = '-'; }
+        string_put_decimal(buffer + exponent_digit_count, ABS(point - 1));
+    } else {
+        for (int i = 0; i < padding_zero_count; i++) { *buffer++ = '0'; }
+        
+        if (point <= 0) {
+            *buffer++ = '0';
+        } else {
+            int copied = MIN(point, digit_count);
+            memory_copy(buffer, digits, copied);
+            buffer += copied;
+            for (int i = copied; i < point; i++) { *buffer++ = '0'; }
+        }
+        
+        if (fraction_length) {
+            *buffer++ = '.';
+            for (int i = 0; i < fraction_length; i++) {
+                int index = point + i;
+                *buffer++ = (index >= 0 && index < digit_count) ? digits[index] : '0';
+            }
+        }
+    }
+    
+    s->length += length;
+    
+    return length;
+}
+
+int string_write_double(string* s, double x, string_write_args args) {
+    union { double value; unsigned long long bits; } convert = { .value = x };
+    
+    bool is_negative = (bool)(convert.bits >> 63);
+    unsigned long long ieee_mantissa = convert.bits & ((1ULL << 52) - 1);
+    int ieee_exponent = (int)((convert.bits >> 52) & 0x7FF);
+    
+    if (ieee_exponent == 0x7FF) {
+        return string_write_c_string(s, ieee_mantissa ? "nan" : (is_negative ? "-inf" : "inf"), args);
+    }
+    
+    string_decimal decimal = { 0 };
+    if (ieee_exponent == 0 && ieee_mantissa != 0) {
+        decimal = string_shortest_decimal(ieee_mantissa, 1 - 1023 - 52 - 2, true);
+    } else if (ieee_exponent != 0) {
+        decimal = string_shortest_decimal((1ULL << 52) | ieee_mantissa, ieee_exponent - 1023 - 52 - 2, 
+                                          ieee_mantissa != 0 || ieee_exponent == 1);
+    }
+    
+    return string_write_decimal(s, is_negative, decimal, args);
+}
+
+// @Note: floats get their own shortest digits, as a double 0.1f would be 0.10000000149011612
+int string_write_float(string* s, float x, string_write_args args) {
+    union { float value; unsigned int bits; } convert = { .value = x };
+    
+    bool is_negative = (bool)(convert.bits >> 31);
+    unsigned int ieee_mantissa = convert.bits & ((1u << 23) - 1);
+    int ieee_exponent = (int)((convert.bits >> 23) & 0xFF);
+    
+    if (ieee_exponent == 0xFF) {
+        return string_write_c_string(s, ieee_mantissa ? "nan" : (is_negative ? "-inf" : "inf"), args);
+    }
+    
+    string_decimal decimal = { 0 };
+    if (ieee_exponent == 0 && ieee_mantissa != 0) {
+        decimal = string_shortest_decimal(ieee_mantissa, 1 - 127 - 23 - 2, true);
+    } else if (ieee_exponent != 0) {
+        decimal = string_shortest_decimal((1u << 23) | ieee_mantissa, ieee_exponent - 127 - 23 - 2, 
+                                          ieee_mantissa != 0 || ieee_exponent == 1);
+    }
+    
+    return string_write_decimal(s, is_negative, decimal, args);
 }
 
 int string_write_string(string* s, string append, string_write_args args) {
@@ -569,18 +1470,28 @@ void _string_print(string str, char* name, print_string_args args) {
 
 // ===============
 // string builder
-typedef struct string_builder_node {
-    char* data;
+// @Info: appended strings are copied into a chain of large chunks, so the builder does not care what happens 
+//        to them afterwards and there is only an allocation every few kilobytes. Chunks come from allocator, 
+//        free may be 0 if the memory does not need to be given back (e.g. when the allocator pushes onto an arena).
+#define STRING_BUILDER_FIRST_CHUNK_SIZE (4 * 1024)
+#define STRING_BUILDER_MAX_CHUNK_SIZE   (1024 * 1024)
+
+typedef struct string_builder_chunk {
+    struct string_builder_chunk* next;
     unsigned int length;
-    struct string_builder_node* next;
-} string_builder_node;
+    unsigned int capacity;
+    char data[];
+} string_builder_chunk;
 
 typedef struct {
-    string_builder_node* front;
-    string_builder_node* end;
-    unsigned int node_count;
+    string_builder_chunk* front;
+    string_builder_chunk* end;
+    unsigned int chunk_count;
     unsigned int total_length;
     
+    // @Info: capacity of the next chunk, doubles with every chunk up to STRING_BUILDER_MAX_CHUNK_SIZE
+    unsigned int chunk_size;
+    
     void* (*allocator)(size_t);
     void  (*free)(void*);
 } string_builder;
@@ -589,8 +1500,9 @@ string_builder make_string_builder(void* (*allocator)(size_t), void (*free)(void
     string_builder result;
     
     result.front = result.end = 0;
-    result.node_count = 0;
+    result.chunk_count = 0;
     result.total_length = 0;
+    result.chunk_size = STRING_BUILDER_FIRST_CHUNK_SIZE;
     
     result.allocator = allocator;
     result.free = free;
@@ -601,69 +1513,226 @@ string_builder make_string_builder(void* (*allocator)(size_t), void (*free)(void
 #define string_builder_append(BUF, STR)       _string_builder_append(BUF, string(STR))
 #define string_builder_append_front(BUF, STR) _string_builder_append_front(BUF, string(STR))
 
+static string_builder_chunk* string_builder_new_chunk(string_builder* builder, unsigned int min_capacity) {
+    unsigned int capacity = MAX(builder->chunk_size, min_capacity);
+    
+    string_builder_chunk* chunk = builder->allocator(sizeof(string_builder_chunk) + capacity);
+    chunk->next = 0;
+    chunk->length = 0;
+    chunk->capacity = capacity;
+    
+    builder->chunk_count++;
+    builder->chunk_size = MIN(builder->chunk_size * 2, STRING_BUILDER_MAX_CHUNK_SIZE);
+    
+    return chunk;
+}
+
 void _string_builder_append(string_builder* builder, string str) {
-    string_builder_node* node = builder->allocator(sizeof(string_builder_node));
+    char* src = str.data;
+    unsigned int remaining = str.length;
     
-    node->data = str.data;
-    node->length = str.length;
-    node->next = 0;
+    if (builder->end) {
+        string_builder_chunk* end = builder->end;
+        unsigned int count = MIN(remaining, end->capacity - end->length);
+        
+        // @Note: memcpy and not memory_copy, that one goes byte by byte and most appends are short
+        memcpy(end->data + end->length, src, count);
+        end->length += count;
+        src += count;
+        remaining -= count;
+    }
     
-    if (!builder->end) {
-        builder->end = builder->front = node;
-    } else {
-        builder->end->next = node;
-        builder->end = node;
+    if (remaining) {
+        string_builder_chunk* chunk = string_builder_new_chunk(builder, remaining);
+        memcpy(chunk->data, src, remaining);
+        chunk->length = remaining;
+        
+        if (builder->end) { builder->end->next = chunk; }
+        else              { builder->front = chunk; }
+        builder->end = chunk;
     }
     
-    builder->node_count++;
     builder->total_length += str.length;
 }
 
+// @Note: gets a chunk of its own that fits exactly, prepending is not meant to be done often
 void _string_builder_append_front(string_builder* builder, string str) {
-    string_builder_node* node = builder->allocator(sizeof(string_builder_node));
+    if (!str.length) { return; }
     
-    node->data = str.data;
-    node->length = str.length;
-    node->next = builder->front;
+    string_builder_chunk* chunk = builder->allocator(sizeof(string_builder_chunk) + str.length);
+    chunk->length = chunk->capacity = str.length;
+    memcpy(chunk->data, str.data, str.length);
     
-    builder->front = node;
+    chunk->next = builder->front;
+    builder->front = chunk;
+    if (!builder->end) { builder->end = chunk; }
     
-    builder->node_count++;
+    builder->chunk_count++;
     builder->total_length += str.length;
 }
 
+void string_builder_clear(string_builder* builder) {
+    if (builder->free) {
+        string_builder_chunk* chunk = builder->front;
+        while (chunk) {
+            string_builder_chunk* temp = chunk;
+            chunk = chunk->next;
+            builder->free(temp);
+        }
+    }
+    
+    *builder = make_string_builder(builder->allocator, builder->free);
+}
+
 // @Note: this also clears
 string string_builder_flush(string_builder* builder) {
     string result;
     result.data = builder->allocator(builder->total_length + 1);
     
-    string_builder_node* node = builder->front;
     unsigned int current_length = 0;
-    while (node) {
-        memory_copy(result.data + current_length, node->data, node->length);
-        current_length += node->length;
-        
-        string_builder_node* temp = node;
-        node = node->next;
-        builder->free(temp);
+    for (string_builder_chunk* chunk = builder->front; chunk; chunk = chunk->next) {
+        memcpy(result.data + current_length, chunk->data, chunk->length);
+        current_length += chunk->length;
     }
     
     result.data[current_length] = '\0';
     result.length = builder->total_length;
     result.size = builder->total_length;
     
-    *builder = make_string_builder(builder->allocator, builder->free);
+    string_builder_clear(builder);
     
     return result;
 }
 
-void string_builder_clear(string_builder* builder) {
-    string_builder_node* node = builder->front;
-    while (node) {
-        string_builder_node* temp = node;
-        node = node->next;
-        builder->free(temp);
+
+// ===============
+// string interning
+// @Info: maps strings to stable ids, the same text always gets the same id. Once two strings are interned, 
+//        comparing them is comparing two integers. Interned strings are copied into memory from the allocator 
+//        (null-terminated) and never freed, so the strings and the ids stay valid for the lifetime of the pool.
+typedef unsigned int string_id;
+#define STRING_ID_NONE 0
+
+// @Info: a string with the length known at compile time. Only works for literals, the "" makes anything else fail to compile.
+#define string_literal(LIT) ((string){ .data = "" LIT "", .length = sizeof(LIT) - 1, .size = sizeof(LIT) })
+
+typedef struct {
+    string str;
+    unsigned int hash;
+} string_intern_entry;
+
+typedef struct {
+    void* (*allocator)(size_t);
+    
+    // @Info: open addressing with linear probing, a slot holds the id of an entry (0 for empty)
+    string_id* slots;
+    unsigned int slot_count; // @Note: always a power of two
+    
+    // @Info: entries[id - 1]
+    string_intern_entry* entries;
+    unsigned int count;
+    unsigned int capacity;
+} string_intern_pool;
+
+// @Info: FNV-1a
+static inline unsigned int string_hash(string str) {
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < str.length; i++) {
+        hash ^= (unsigned char)str.data[i];
+        hash *= 16777619u;
     }
     
-    *builder = make_string_builder(builder->allocator, builder->free);
+    return hash;
+}
+
+// @Info: the hash the pool uses, a test can swap in a worse one to get collisions
+#ifndef STRING_INTERN_HASH
+    #define STRING_INTERN_HASH(str) string_hash(str)
+#endif
+
+string_intern_pool make_string_intern_pool(void* (*allocator)(size_t), unsigned int initial_capacity) {
+    string_intern_pool result = { .allocator = allocator };
+    
+    result.slot_count = 16;
+    while (result.slot_count < initial_capacity * 2) { result.slot_count *= 2; }
+    
+    result.capacity = result.slot_count / 2;
+    result.slots = allocator(sizeof(string_id) * result.slot_count);
+    result.entries = allocator(sizeof(string_intern_entry) * result.capacity);
+    
+    for (unsigned int i = 0; i < result.slot_count; i++) { result.slots[i] = STRING_ID_NONE; }
+    
+    return result;
+}
+
+// @Info: returns the slot that holds str, or the empty slot where it would go
+static unsigned int string_intern_find_slot(string_intern_pool* pool, string str, unsigned int hash) {
+    unsigned int mask = pool->slot_count - 1;
+    unsigned int slot = hash & mask;
+    
+    while (pool->slots[slot] != STRING_ID_NONE) {
+        string_intern_entry* entry = &pool->entries[pool->slots[slot] - 1];
+        if (entry->hash == hash && string_compare(entry->str, str)) { return slot; }
+        
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+// @Note: the allocator has no free, the old arrays are just left behind. They are small and this only happens log(n) times.
+static void string_intern_grow(string_intern_pool* pool) {
+    unsigned int slot_count = pool->slot_count * 2;
+    unsigned int capacity = slot_count / 2;
+    
+    string_id* slots = pool->allocator(sizeof(string_id) * slot_count);
+    string_intern_entry* entries = pool->allocator(sizeof(string_intern_entry) * capacity);
+    
+    for (unsigned int i = 0; i < slot_count; i++) { slots[i] = STRING_ID_NONE; }
+    for (unsigned int i = 0; i < pool->count; i++) { entries[i] = pool->entries[i]; }
+    
+    for (unsigned int i = 0; i < pool->count; i++) {
+        unsigned int slot = entries[i].hash & (slot_count - 1);
+        while (slots[slot] != STRING_ID_NONE) { slot = (slot + 1) & (slot_count - 1); }
+        slots[slot] = i + 1;
+    }
+    
+    pool->slots = slots;
+    pool->slot_count = slot_count;
+    pool->entries = entries;
+    pool->capacity = capacity;
+}
+
+// @Info: returns the id of str, str is added to the pool if it is not in there yet
+string_id string_intern(string_intern_pool* pool, string str) {
+    unsigned int hash = STRING_INTERN_HASH(str);
+    unsigned int slot = string_intern_find_slot(pool, str, hash);
+    if (pool->slots[slot] != STRING_ID_NONE) { return pool->slots[slot]; }
+    
+    if (pool->count == pool->capacity) {
+        string_intern_grow(pool);
+        slot = string_intern_find_slot(pool, str, hash);
+    }
+    
+    string_intern_entry* entry = &pool->entries[pool->count];
+    entry->hash = hash;
+    entry->str.data = pool->allocator(str.length + 1);
+    entry->str.length = str.length;
+    entry->str.size = str.length + 1;
+    memory_copy(entry->str.data, str.data, str.length);
+    entry->str.data[str.length] = 0;
+    
+    pool->slots[slot] = ++pool->count;
+    return pool->slots[slot];
+}
+
+// @Info: like string_intern, but returns STRING_ID_NONE instead of adding str
+string_id string_intern_find(string_intern_pool* pool, string str) {
+    unsigned int slot = string_intern_find_slot(pool, str, STRING_INTERN_HASH(str));
+    return pool->slots[slot];
+}
+
+string string_from_id(string_intern_pool* pool, string_id id) {
+    if (id == STRING_ID_NONE || id > pool->count) { return (string) { 0 }; }
+    return pool->entries[id - 1].str;
 }
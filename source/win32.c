@@ -11,29 +11,50 @@
 
 #define win32_handle_failed_assertion platform_handle_failed_assertion
 #define win32_add_file_watch          platform_add_file_watch
+#define win32_clear_file_watches      platform_clear_file_watches
 #define win32_find_all_files          platform_find_all_files
 #define win32_sleep                   platform_sleep
+#define win32_get_ticks               platform_get_ticks
+#define win32_get_tick_frequency      platform_get_tick_frequency
+#define win32_map_file                platform_map_file
+#define win32_unmap_file              platform_unmap_file
+#define win32_get_page_size           platform_get_page_size
+#define win32_reserve_memory          platform_reserve_memory
+#define win32_commit_memory           platform_commit_memory
+#define win32_decommit_memory         platform_decommit_memory
+#define win32_release_memory          platform_release_memory
+#define win32_map_file_into_reserved  platform_map_file_into_reserved
+
+#include "game.h"
+
+// @Info: DEV builds load the game from game.dll (see game_module.c) and reload it whenever it gets rebuilt
+#ifndef GAME_HOT_RELOAD
+    #define GAME_HOT_RELOAD DEV
+#endif
 
+#if !GAME_HOT_RELOAD
 #include "game.c"
+#endif
 
 typedef struct {
     HWND window_handle;
     platform_info* platform;
+    game_code* game;
 } win32_window_data;
 
-typedef struct {
-    FILETIME last_write_time;
-    string path;
-    void (*callback)(string, void*);
-    void* data;
-} win32_file_watch_info;
+#include "file_watch.c"
+#include "frame_timing.c"
 
 #if DEV
-    #define MAX_FILE_WATCH_COUNT 128
-    win32_file_watch_info files_to_watch[MAX_FILE_WATCH_COUNT];
-    int file_watch_count = 0;
-#endif
+typedef struct {
+    HANDLE handle;
+    OVERLAPPED overlapped;
+    DWORD buffer[4096]; // @Note: FILE_NOTIFY_INFORMATION has to be DWORD aligned
+} win32_watched_directory;
 
+HANDLE file_watch_port;
+win32_watched_directory win32_watched_directories[MAX_WATCHED_DIRECTORY_COUNT]; // @Info: by watched directory index
+#endif
 
 static void win32_handle_failed_assertion(char* expr_str, char* file, int line) {
     report("Assertion at %s:%d failed!\n\t%s\n", file, line, expr_str);
@@ -44,6 +65,18 @@ static inline void win32_sleep(u64 time) {
     Sleep(time);
 }
 
+static u64 win32_get_ticks() {
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter(&ticks);
+    return ticks.QuadPart;
+}
+
+static u64 win32_get_tick_frequency() {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return frequency.QuadPart;
+}
+
 static LRESULT CALLBACK win32_main_window_proc(HWND window, UINT message, WPARAM wparam, LPARAM lparam) {
     win32_window_data* window_data = (win32_window_data*)GetWindowLongPtr(window, GWLP_USERDATA);
     if (!window_data) { return DefWindowProc(window, message, wparam, lparam); }
@@ -59,7 +92,7 @@ static LRESULT CALLBACK win32_main_window_proc(HWND window, UINT message, WPARAM
         case WM_SIZE: {
             window_data->platform->window_width = LOWORD(lparam);
             window_data->platform->window_height = HIWORD(lparam);
-            game_resize_window(window_data->platform);
+            window_data->game->resize_window(window_data->platform);
         } break;
         
         case WM_CHAR: {
@@ -148,7 +181,7 @@ static LRESULT CALLBACK win32_main_window_proc(HWND window, UINT message, WPARAM
     return result;
 }
 
-static int win32_find_all_files(char* dir, char* format, void* memory, u64* bytes_used) {
+static int win32_find_all_files(char* dir, char* format, void* memory, u64 capacity, u64* bytes_used) {
     WIN32_FIND_DATA find_data;
     int dir_len = strlen(dir);
 
@@ -165,6 +198,11 @@ static int win32_find_all_files(char* dir, char* format, void* memory, u64* byte
     do {
         if (find_data.cFileName[0] == '.') { continue; }
         int len = strlen(find_data.cFileName);
+        if (dest + len + 1 > (u8*)memory + capacity) {
+            report("Not all files in %s fit into %llu bytes\n", dir, capacity);
+            break;
+        }
+        
         strcpy(dest, find_data.cFileName);
         dest[len] = '\0';
         dest += len + 1;
@@ -178,6 +216,105 @@ static int win32_find_all_files(char* dir, char* format, void* memory, u64* byte
     return i;
 }
 
+// @Info: maps at most size bytes from the start of the file read-only. 
+//        mapped_size is set to what was actually mapped, which is less if the file is smaller.
+static void* win32_map_file(char* path, u64 size, u64* mapped_size) {
+    *mapped_size = 0;
+    
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) { return 0; }
+    
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return 0;
+    }
+    
+    u64 to_map = MIN(size, (u64)file_size.QuadPart);
+    
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    void* result = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, to_map) : 0;
+    
+    // @Note: the view keeps the mapping alive, we don't need the handles anymore
+    if (mapping) { CloseHandle(mapping); }
+    CloseHandle(file);
+    
+    if (result) { *mapped_size = to_map; }
+    
+    return result;
+}
+
+static void win32_unmap_file(void* memory) {
+    if (memory) { UnmapViewOfFile(memory); }
+}
+
+static u64 win32_get_page_size() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+// @Note: reservations are rounded to the 64K allocation granularity
+static void* win32_reserve_memory(void* base, u64 size) {
+    return VirtualAlloc(base, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+static bool win32_commit_memory(void* memory, u64 size) {
+    return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+static void win32_decommit_memory(void* memory, u64 size) {
+    VirtualFree(memory, size, MEM_DECOMMIT);
+}
+
+static void win32_release_memory(void* memory, u64 size) {
+    VirtualFree(memory, 0, MEM_RELEASE);
+}
+
+// @Info: releases whatever reservations and views there are in the range
+static void win32_release_region(void* base, u64 size) {
+    u8* at = base;
+    u8* end = at + size;
+    
+    while (at < end) {
+        MEMORY_BASIC_INFORMATION info;
+        if (!VirtualQuery(at, &info, sizeof(info))) { break; }
+        
+        if (info.State != MEM_FREE) {
+            if (info.Type == MEM_MAPPED) { UnmapViewOfFile(info.AllocationBase); }
+            else                         { VirtualFree(info.AllocationBase, 0, MEM_RELEASE); }
+        }
+        
+        at = (u8*)info.BaseAddress + info.RegionSize;
+    }
+}
+
+// @Note: a view can not be put into a reservation on windows, so the region (or the view and the reservation 
+//        behind it from an earlier call) gets released and the view and a new reservation take its place
+static bool win32_map_file_into_reserved(char* path, u64 offset, u64 size, void* base, u64 region_size) {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping) { return false; }
+    
+    win32_release_region(base, region_size);
+    
+    void* view = MapViewOfFileEx(mapping, FILE_MAP_COPY, (DWORD)(offset >> 32), (DWORD)offset, size, base);
+    CloseHandle(mapping);
+    
+    bool ok = view == base;
+    if (ok && size < region_size) { ok = VirtualAlloc((u8*)base + size, region_size - size, MEM_RESERVE, PAGE_NOACCESS) != 0; }
+    
+    if (!ok) {
+        win32_release_region(base, region_size);
+        win32_reserve_memory(base, region_size);
+    }
+    
+    return ok;
+}
+
 static MONITORINFO win32_get_primary_monitor_info() {
     POINT zero = {0, 0};
     HMONITOR monitor_handle = MonitorFromPoint(zero, MONITOR_DEFAULTTOPRIMARY);
@@ -207,44 +344,204 @@ static void win32_check_for_messages(HWND window_handle) {
     }
 }
 
-static inline FILETIME win32_get_last_write_time(string file_path) {
-    char _path[256];
-    memory_copy(_path, file_path.data, file_path.length);
-    _path[file_path.length] = 0;
+#if DEV
+static bool win32_read_directory_changes(win32_watched_directory* directory) {
+    directory->overlapped = (OVERLAPPED){ 0 };
+    return ReadDirectoryChangesW(directory->handle, directory->buffer, sizeof(directory->buffer), FALSE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, 0, &directory->overlapped, 0);
+}
 
-    FILETIME result = { 0 };
-    WIN32_FILE_ATTRIBUTE_DATA data;
-    if (GetFileAttributesExA(_path, GetFileExInfoStandard, &data)) {
-        result = data.ftLastWriteTime;
+// @Info: the completion key is the directory index
+static DWORD WINAPI win32_file_watcher_thread(LPVOID unused) {
+    u64 wait = (u64)-1;
+    
+    while (true) {
+        DWORD bytes;
+        ULONG_PTR key;
+        OVERLAPPED* overlapped;
+        
+        if (GetQueuedCompletionStatus(file_watch_port, &bytes, &key, &overlapped, (wait == (u64)-1) ? INFINITE : (DWORD)wait)) {
+            win32_watched_directory* directory = &win32_watched_directories[key];
+            u64 now = GetTickCount64();
+            
+            // @Note: zero bytes means the buffer overflowed and the changes in it are lost
+            u8* at = (u8*)directory->buffer;
+            while (bytes) {
+                FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*)at;
+                
+                if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || 
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                    char name[FILE_WATCH_NAME_LENGTH];
+                    int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, info->FileNameLength / sizeof(WCHAR), 
+                                                     name, sizeof(name), 0, 0);
+                    if (length > 0) { file_watch_note_change((u32)key, name, length, now); }
+                }
+                
+                if (!info->NextEntryOffset) { break; }
+                at += info->NextEntryOffset;
+            }
+            
+            win32_read_directory_changes(directory);
+        }
+        
+        wait = file_watch_flush_pending(GetTickCount64());
     }
     
-    return result;
+    return 0;
 }
 
+static int win32_watch_directory(string directory) {
+    if (!file_watch_port) {
+        file_watch_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, 0, 0, 1);
+        HANDLE thread = file_watch_port ? CreateThread(0, 0, win32_file_watcher_thread, 0, 0, 0) : 0;
+        
+        if (!thread) {
+            report("Could not start the file watcher thread: %i\n", GetLastError());
+            if (file_watch_port) { CloseHandle(file_watch_port); }
+            file_watch_port = 0;
+            return -1;
+        }
+        CloseHandle(thread);
+    }
+    
+    char path[256];
+    assert(directory.length < sizeof(path) - 1);
+    memory_copy(path, directory.data, directory.length);
+    path[directory.length] = 0;
+    
+    u32 index = watched_directory_count;
+    assert(index < MAX_WATCHED_DIRECTORY_COUNT);
+    win32_watched_directory* watched = &win32_watched_directories[index];
+    
+    watched->handle = CreateFileA(directory.length ? path : ".", FILE_LIST_DIRECTORY, 
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0, OPEN_EXISTING, 
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, 0);
+    
+    if (watched->handle == INVALID_HANDLE_VALUE) {
+        report("Could not watch %s: %i\n", path, GetLastError());
+        return -1;
+    }
+    
+    if (!CreateIoCompletionPort(watched->handle, file_watch_port, index, 0) || !win32_read_directory_changes(watched)) {
+        report("Could not watch %s: %i\n", path, GetLastError());
+        CloseHandle(watched->handle);
+        return -1;
+    }
+    
+    return file_watch_publish_directory(directory);
+}
+#endif
+
 static void win32_add_file_watch(string path, void (*callback)(string, void*), void* data) {
 #if DEV
-    assert(MAX_FILE_WATCH_COUNT > file_watch_count);
-    files_to_watch[file_watch_count++] = (win32_file_watch_info){ 
-        .last_write_time = win32_get_last_write_time(path), 
-        .path = path, 
-        .callback = callback,
-        .data = data };
+    string directory, name;
+    file_watch_split_path(path, &directory, &name);
+    
+    int index = file_watch_find_directory(directory);
+    if (index < 0) { index = win32_watch_directory(directory); }
+    if (index < 0) { return; }
+    
+    file_watch_add(index, path, name, callback, data);
 #endif
 }
 
+static void win32_clear_file_watches() {
+    file_watch_clear();
+}
 
-static void win32_check_file_watchers() {
-    for (int i = 0; i < file_watch_count; i++) {
-        win32_file_watch_info* watch = &files_to_watch[i];
-        FILETIME write_time = win32_get_last_write_time(watch->path);
-        
-        if (CompareFileTime(&write_time, &watch->last_write_time) != 0) {
-            watch->callback(watch->path, watch->data);
-            watch->last_write_time = write_time;
-        }
+// @Info: wglGetProcAddress only knows what came after OpenGL 1.1, the rest comes straight from opengl32.dll
+static void* win32_gl_get_proc_address(const char* name) {
+    void* result = (void*)wglGetProcAddress(name);
+    
+    // @Note: some drivers return small numbers instead of 0
+    if ((u64)result <= 3 || result == (void*)-1) {
+        static HMODULE opengl = 0;
+        if (!opengl) { opengl = LoadLibraryA("opengl32.dll"); }
+        result = (void*)GetProcAddress(opengl, name);
     }
+    
+    return result;
 }
 
+// === game module
+#if GAME_HOT_RELOAD
+typedef struct {
+    HMODULE library;
+    game_code code;
+    
+    u32 load_count;
+    bool changed;   // @Info: set by the file watch on game.dll
+} win32_game_module;
+
+#define GAME_MODULE_PATH      "./game.dll"
+#define GAME_MODULE_LOCK_PATH "lock.tmp"    // @Info: build.bat writes it while game.dll is being built
+
+// @Info: windows does not let anyone replace a loaded DLL, so what gets loaded is a copy. The two copies take turns,
+//        the older one is unloaded by the time its name comes up again.
+static bool win32_load_game_module(win32_game_module* module) {
+    char path[64];
+    snprintf(path, sizeof(path), "game_loaded_%u.dll", module->load_count % 2);
+    
+    if (!CopyFileA(GAME_MODULE_PATH, path, FALSE)) {
+        report("Could not copy %s: %i\n", GAME_MODULE_PATH, GetLastError());
+        return false;
+    }
+    
+    module->library = LoadLibraryA(path);
+    if (!module->library) {
+        report("Could not load %s: %i\n", GAME_MODULE_PATH, GetLastError());
+        return false;
+    }
+    
+    module->code = (game_code){
+        .init_memory        = (game_init_memory_proc*)GetProcAddress(module->library, "game_init_memory"),
+        .update_and_render  = (game_update_and_render_proc*)GetProcAddress(module->library, "game_update_and_render"),
+        .resize_window      = (game_resize_window_proc*)GetProcAddress(module->library, "game_resize_window"),
+        .load_last_snapshot = (game_load_last_snapshot_proc*)GetProcAddress(module->library, "game_load_last_snapshot"),
+        .unload             = (game_unload_proc*)GetProcAddress(module->library, "game_unload"),
+        .reload             = (game_reload_proc*)GetProcAddress(module->library, "game_reload") };
+    
+    game_code* code = &module->code;
+    if (!code->init_memory || !code->update_and_render || !code->resize_window || !code->load_last_snapshot ||
+        !code->unload || !code->reload) {
+        report("%s is missing some of the game functions\n", GAME_MODULE_PATH);
+        FreeLibrary(module->library);
+        module->library = 0;
+        return false;
+    }
+    
+    module->load_count++;
+    return true;
+}
+
+static void win32_game_module_changed(string path, void* data) {
+    win32_game_module* module = data;
+    module->changed = true;
+}
+
+// @Info: once per frame. The new module gets loaded before the old one goes, so a broken build keeps the old one
+//        running.
+static void win32_reload_game_module_if_changed(win32_game_module* module, platform_info* platform) {
+    if (!module->changed) { return; }
+    
+    // @Note: the linker writes game.dll in more than one go, it is done once build.bat deletes the lock
+    if (GetFileAttributesA(GAME_MODULE_LOCK_PATH) != INVALID_FILE_ATTRIBUTES) { return; }
+    module->changed = false;
+    
+    win32_game_module new_module = { .load_count = module->load_count };
+    bool loaded = win32_load_game_module(&new_module);
+    module->load_count = new_module.load_count;
+    if (!loaded) { return; }
+    
+    module->code.unload(platform);
+    FreeLibrary(module->library);
+    
+    module->library = new_module.library;
+    module->code = new_module.code;
+    module->code.reload(platform);
+}
+#endif
+
 int WINAPI WinMain(HINSTANCE instance, HINSTANCE prev_instance, PSTR args, int show_code) {
 #if DEV
     AllocConsole();
@@ -256,8 +553,9 @@ int WINAPI WinMain(HINSTANCE instance, HINSTANCE prev_instance, PSTR args, int s
     platform.is_running = 1;
     
     { // === allocate game memory
-        platform.permanent_storage_size = megabytes(512);
-        platform.transient_storage_size = megabytes(512);
+        // @Info: this is only address space, pages get committed as the arenas grow
+        platform.permanent_storage_size = gigabytes(8);
+        platform.transient_storage_size = gigabytes(8);
         
 #if DEV
         LPVOID game_memory_base = (LPVOID)terabytes(1);
@@ -265,24 +563,52 @@ int WINAPI WinMain(HINSTANCE instance, HINSTANCE prev_instance, PSTR args, int s
         LPVOID game_memory_base = 0;
 #endif
 
-        platform.permanent_storage = VirtualAlloc(game_memory_base,
-            platform.permanent_storage_size + platform.transient_storage_size,
-            MEM_COMMIT | MEM_RESERVE,
-            PAGE_READWRITE);
+        // @Note: two separate reservations, so that loading a snapshot can replace the permanent one on its own
+        platform.permanent_storage = win32_reserve_memory(game_memory_base,
+            platform.permanent_storage_size + MEMORY_GUARD_SIZE);
         
-        if (!platform.permanent_storage) {
-            report("Failed to allocate the games memory\n");
-            return 1;        
+        if (platform.permanent_storage) {
+            u8* transient_base = (u8*)platform.permanent_storage + platform.permanent_storage_size + MEMORY_GUARD_SIZE;
+            platform.transient_storage = win32_reserve_memory(transient_base, platform.transient_storage_size + MEMORY_GUARD_SIZE);
+            
+            if (!platform.transient_storage) {
+                platform.transient_storage = win32_reserve_memory(0, platform.transient_storage_size + MEMORY_GUARD_SIZE);
+            }
         }
         
-        platform.transient_storage = (u8*)platform.permanent_storage + platform.permanent_storage_size;
+        if (!platform.permanent_storage || !platform.transient_storage) {
+            report("Failed to reserve the games memory\n");
+            return 1;        
+        }
     }
 
     int screen_width, screen_height;
     win32_get_primary_screen_dimensions_without_taskbar(&screen_width, &screen_height);
     
+    platform.api = get_platform_api();
+    platform.gl_get_proc_address = win32_gl_get_proc_address;
+    
+#if GAME_HOT_RELOAD
+    win32_game_module module = { 0 };
+    if (!win32_load_game_module(&module)) { return 1; }
+    
+    // @Note: before the game adds its own
+    win32_add_file_watch(string(GAME_MODULE_PATH), win32_game_module_changed, &module);
+    file_watch_keep_current();
+    
+    game_code* game = &module.code;
+#else
+    game_code unity_game = {
+        .init_memory        = game_init_memory,
+        .update_and_render  = game_update_and_render,
+        .resize_window      = game_resize_window,
+        .load_last_snapshot = game_load_last_snapshot };
+    game_code* game = &unity_game;
+#endif
+    
     win32_window_data window_data;
     window_data.platform = &platform;
+    window_data.game = game;
     
     { // === init window
         WNDCLASSEX window_class = { 0 };
@@ -384,28 +710,38 @@ int WINAPI WinMain(HINSTANCE instance, HINSTANCE prev_instance, PSTR args, int s
         gladLoadGL();
     }
     
-    game_init_memory(&platform);
+    game->init_memory(&platform);
     
-    FILETIME system_time;
-    GetSystemTimeAsFileTime(&system_time);
+#if DEV
+    if (strstr(args, "-resume")) { game->load_last_snapshot(&platform); }
+#endif
+    
+    if (strstr(args, "-fps ")) { platform.target_frame_rate = atoi(strstr(args, "-fps ") + 5); }
     
-    u32 previous_time = system_time.dwLowDateTime;
-    platform.current_time = previous_time;
+    // @Note: makes Sleep(1) take about a millisecond instead of up to 15.6, so the frame limiter can sleep
+    //        most of the wait and only spin for the rest
+    timeBeginPeriod(1);
+    
+    frame_timer timer;
+    init_frame_timer(&timer, platform.target_frame_rate);
     
     while (platform.is_running) {
         win32_check_for_messages(window_data.window_handle);
-        win32_check_file_watchers();
-        
-        GetSystemTimeAsFileTime(&system_time);
-        previous_time = platform.current_time;
-        platform.current_time = system_time.dwLowDateTime;
-        platform.dt_ms = (platform.current_time - previous_time) / 10000.0;
+        check_file_watchers();
+#if GAME_HOT_RELOAD
+        win32_reload_game_module_if_changed(&module, &platform);
+#endif
         
-        game_update_and_render(&platform);
+        frame_timer_begin_platform_frame(&timer, &platform);
+        game->update_and_render(&platform);
         
         platform.event_count = 0;
         SwapBuffers(device_context);
+        
+        frame_timer_wait(&timer);
     }
     
+    timeEndPeriod(1);
+    
     return 0;
 }
@@ -0,0 +1,208 @@
+// @Info: alignment of the arena pushes in memory.c. Random interleaved pushes of mixed sizes and types, with saves
+//        and restores in between, on arenas whose base is off by anything from 0 to 63 bytes. Every pointer has to
+//        be aligned to what was asked for, SIMD_ALIGNMENT pushes get read with aligned vector loads, the zeroing
+//        pushes have to be zero on memory that was dirty, and no push may overlap the one before it.
+
+#include "test.h"
+#include "../source/game_module.c"
+
+#define ROUND_COUNT 64
+#define PUSHES_PER_ROUND 4000
+#define TEST_ARENA_SIZE megabytes(16)
+
+// @Info: wider than anything the types ask for, so a push has to pad even when SIMD_ALIGNMENT does not
+typedef struct {
+    _Alignas(64) u8 bytes[40];
+} cache_line_thing;
+
+typedef enum {
+    PUSH_SIZE,
+    PUSH_SIZE_ALIGNED,
+    PUSH_SIZE_SIMD,
+    PUSH_SIZE_ZERO,
+    PUSH_ARRAY_U8,
+    PUSH_ARRAY_U64,
+    PUSH_ARRAY_VEC3,
+    PUSH_ARRAY_MAT4,
+    PUSH_ARRAY_SIMD_TYPE,
+    PUSH_ARRAY_ZERO_MAT4,
+    PUSH_ARRAY_ZERO_CACHE_LINE,
+    PUSH_STRUCT_CACHE_LINE,
+    PUSH_KIND_COUNT
+} push_kind;
+
+static bool test_commit_memory(void* memory, unsigned long long size) {
+    return true;
+}
+
+static bool is_aligned(void* pointer, u64 alignment) {
+    return ((u64)pointer & (alignment - 1)) == 0;
+}
+
+static bool is_zero(u8* memory, u64 size) {
+    for (u64 i = 0; i < size; i++) { if (memory[i]) { return false; } }
+    return true;
+}
+
+// @Note: an aligned load faults on a misaligned address, the sum only keeps the compiler from dropping it
+static float aligned_load(void* memory, u64 size) {
+    float result = 0;
+#if VECTOR_SIMD_AVX2
+    if (size >= 32) { result += _mm_cvtss_f32(_mm256_castps256_ps128(_mm256_load_ps(memory))); }
+#endif
+#if VECTOR_SIMD_SSE
+    if (size >= 16) { result += _mm_cvtss_f32(_mm_load_ps(memory)); }
+#endif
+    return result;
+}
+
+static void test_interleaved_pushes(memory_arena* arena, char* name) {
+    float sum = 0;
+    
+    for (int round = 0; round < ROUND_COUNT; round++) {
+        // @Note: what the last round left behind is dirty, the zeroing pushes have to clear it
+        memset(arena->base, 0xAB, arena->used);
+        clear_arena(arena);
+        
+        arena_marker markers[8];
+        int marker_count = 0;
+        u8* previous_end = arena->base;
+        
+        for (int i = 0; i < PUSHES_PER_ROUND; i++) {
+            if (test_random_int(0, 99) == 0 && marker_count < 8) {
+                markers[marker_count++] = save_arena(arena);
+            } else if (test_random_int(0, 99) == 0 && marker_count) {
+                arena_marker marker = markers[--marker_count];
+                memset((u8*)arena->base + marker.used, 0xAB, arena->used - marker.used);
+                restore_arena(marker);
+                previous_end = (u8*)arena->base + arena->used;
+            }
+            
+            int count = test_random_int(0, 3) ? test_random_int(1, 8) : test_random_int(9, 300);
+            push_kind kind = test_random_int(0, PUSH_KIND_COUNT - 1);
+            
+            u8* result = 0;
+            u64 size = 0, alignment = 1;
+            bool zeroed = false;
+            
+            switch (kind) {
+                case PUSH_SIZE: {
+                    size = count;
+                    result = push_size(arena, size);
+                    check_message(result == previous_end, "%s: push_size of %llu is not right after the push before it", name, size);
+                } break;
+                case PUSH_SIZE_ALIGNED: {
+                    size = count;
+                    alignment = 1ull << test_random_int(0, 12);
+                    result = push_size_aligned(arena, size, alignment);
+                } break;
+                case PUSH_SIZE_SIMD: {
+                    size = count * 4;
+                    alignment = SIMD_ALIGNMENT;
+                    result = push_size_aligned(arena, size, alignment);
+                } break;
+                case PUSH_SIZE_ZERO: {
+                    size = count;
+                    alignment = SIMD_ALIGNMENT;
+                    result = push_size_zero(arena, size, alignment);
+                    zeroed = true;
+                } break;
+                case PUSH_ARRAY_U8: {
+                    size = count;
+                    result = (u8*)push_array(arena, u8, count);
+                } break;
+                case PUSH_ARRAY_U64: {
+                    size = count * sizeof(u64);
+                    alignment = _Alignof(u64);
+                    result = (u8*)push_array(arena, u64, count);
+                } break;
+                case PUSH_ARRAY_VEC3: {
+                    size = count * sizeof(vec3);
+                    alignment = _Alignof(vec3);
+                    result = (u8*)push_array(arena, vec3, count);
+                } break;
+                case PUSH_ARRAY_MAT4: {
+                    size = count * sizeof(mat4);
+                    alignment = VECTOR_SIMD_SSE ? 16 : _Alignof(mat4);
+                    result = (u8*)push_array(arena, mat4, count);
+                } break;
+                case PUSH_ARRAY_SIMD_TYPE: {
+#if VECTOR_SIMD_AVX2
+                    size = count * sizeof(__m256);
+                    alignment = 32;
+                    result = (u8*)push_array(arena, __m256, count);
+#elif VECTOR_SIMD_SSE
+                    size = count * sizeof(__m128);
+                    alignment = 16;
+                    result = (u8*)push_array(arena, __m128, count);
+#else
+                    size = count * sizeof(float);
+                    alignment = _Alignof(float);
+                    result = (u8*)push_array(arena, float, count);
+#endif
+                } break;
+                case PUSH_ARRAY_ZERO_MAT4: {
+                    size = count * sizeof(mat4);
+                    alignment = VECTOR_SIMD_SSE ? 16 : _Alignof(mat4);
+                    result = (u8*)push_array_zero(arena, mat4, count);
+                    zeroed = true;
+                } break;
+                case PUSH_ARRAY_ZERO_CACHE_LINE: {
+                    size = count * sizeof(cache_line_thing);
+                    alignment = 64;
+                    result = (u8*)push_array_zero(arena, cache_line_thing, count);
+                    zeroed = true;
+                } break;
+                case PUSH_STRUCT_CACHE_LINE: {
+                    size = sizeof(cache_line_thing);
+                    alignment = 64;
+                    result = (u8*)push_struct(arena, cache_line_thing);
+                } break;
+                default: break;
+            }
+            
+            check_message(result != 0, "%s: push %d of round %d failed", name, i, round);
+            if (!result) { return; }
+            
+            check_message(is_aligned(result, alignment), "%s: push of kind %d at %p is not aligned to %llu", name, kind, result, alignment);
+            check_message(result >= previous_end, "%s: push of kind %d overlaps the one before it", name, kind);
+            check_message(result + size == (u8*)arena->base + arena->used, "%s: push of kind %d does not end where the arena does", name, kind);
+            if (zeroed) { check_message(is_zero(result, size), "%s: zeroing push of kind %d of %llu bytes is not zero", name, kind, size); }
+            
+            if (alignment >= SIMD_ALIGNMENT) { sum += aligned_load(result, size); }
+            
+            // @Note: dirty it right away, so a later zeroing push that overlaps would show
+            memset(result, 0xCD, size);
+            previous_end = result + size;
+        }
+    }
+    
+    test_sink += sum;
+}
+
+int main() {
+    platform_commit_memory = test_commit_memory;
+    
+    u8* memory = malloc(TEST_ARENA_SIZE + 64);
+    
+    // @Note: the alignment is about the address, so the base of the arena is off by everything from 0 to 63 bytes
+    for (int offset = 0; offset < 64; offset += test_random_int(1, 9)) {
+        memory_arena arena;
+        init_arena(&arena, TEST_ARENA_SIZE, memory + offset);
+        
+        char name[64];
+        sprintf(name, "base + %d", offset);
+        test_interleaved_pushes(&arena, name);
+    }
+    
+    // @Note: a reserved arena commits as it goes, the pushes that commit have to align the same
+    memory_arena reserved;
+    init_reserved_arena(&reserved, TEST_ARENA_SIZE, memory + 3);
+    test_interleaved_pushes(&reserved, "reserved");
+    check(reserved.committed >= reserved.high_water);
+    
+    printf("  SIMD_ALIGNMENT is %d\n", SIMD_ALIGNMENT);
+    
+    free(memory);
+    return test_finish("arena");
+}
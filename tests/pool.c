@@ -0,0 +1,159 @@
+// @Info: the pool allocator of memory.c against malloc/free. First that it hands out distinct, aligned elements and
+//        reuses freed ones before it grows, then churn like the game makes it: random allocs and frees around a
+//        steady number of live elements, and bursts where everything is freed again.
+//
+//        Built without MEMORY_POOL_DEBUG like a release build, the poison fills would be measured otherwise.
+
+#define MEMORY_POOL_DEBUG 0
+
+#include "test.h"
+#include "../source/game_module.c"
+
+#define LIVE_COUNT 10000
+#define CHURN_OP_COUNT 4000000
+#define BURST_SIZE 100000
+#define BURST_COUNT 20
+
+static memory_arena test_arena;
+
+typedef struct {
+    u64 id;
+    u8 payload[56];
+} element_64;
+
+typedef struct {
+    u64 id;
+    u8 payload[248];
+} element_256;
+
+static void test_pool_basics() {
+    arena_marker marker = save_arena(&test_arena);
+    
+    memory_pool pool;
+    init_pool(&pool, &test_arena, 24, 16, 64);
+    
+    // @Note: one element smaller than a free list node and one with an odd size, both get rounded up
+    memory_pool tiny;
+    init_pool(&tiny, &test_arena, 3, 1, 7);
+    check(tiny.element_size >= sizeof(void*) && tiny.element_size % _Alignof(void*) == 0);
+    
+    void* elements[1000];
+    for (int i = 0; i < 1000; i++) {
+        elements[i] = pool_alloc(&pool);
+        check_message(elements[i] && ((u64)elements[i] & 15) == 0, "element %d at %p is not 16 byte aligned", i, elements[i]);
+        memset(elements[i], i & 0xFF, 24);
+    }
+    check(pool.used_count == 1000 && pool.capacity == 1024);
+    
+    // @Note: nothing may overlap, every element still holds what was written into it
+    for (int i = 0; i < 1000; i++) {
+        u8* bytes = elements[i];
+        bool intact = true;
+        for (int b = 0; b < 24; b++) { intact = intact && bytes[b] == (i & 0xFF); }
+        check_message(intact, "element %d was overwritten", i);
+    }
+    
+    for (int i = 0; i < 1000; i += 2) { pool_free(&pool, elements[i]); }
+    check(pool.used_count == 500);
+    
+    // @Note: the freed ones come back before the pool pushes another block
+    u64 used_before = test_arena.used;
+    for (int i = 0; i < 500; i++) {
+        void* element = pool_alloc(&pool);
+        bool was_freed = false;
+        for (int j = 0; j < 1000 && !was_freed; j += 2) { was_freed = elements[j] == element; }
+        check_message(was_freed, "pool_alloc handed out %p, not a freed element", element);
+    }
+    check(test_arena.used == used_before && pool.capacity == 1024);
+    
+    pool_free(&pool, 0);
+    check(pool.used_count == 1000);
+    
+    restore_arena(marker);
+}
+
+// @Info: the same random sequence for both: keeps around LIVE_COUNT elements and frees a random one or allocates a
+//        new one every step. Each element gets written to so the memory is actually touched.
+#define CHURN(ns, alloc, free_element) do {                                                              \
+        bench(ns, CHURN_OP_COUNT, {                                                                      \
+            unsigned long long state = test_random_state;                                                \
+            int live_count = 0;                                                                          \
+            for (int op = 0; op < CHURN_OP_COUNT; op++) {                                                \
+                state ^= state >> 12; state ^= state << 25; state ^= state >> 27;                        \
+                u32 random = (u32)((state * 0x2545F4914F6CDD1Dull) >> 32);                               \
+                if (live_count < LIVE_COUNT / 2 || (live_count < LIVE_COUNT && (random & 1))) {          \
+                    u64* element = alloc;                                                                \
+                    element[0] = op;                                                                     \
+                    live[live_count++] = element;                                                        \
+                } else {                                                                                 \
+                    u32 index = (random >> 1) % live_count;                                              \
+                    sum += *(u64*)live[index];                                                           \
+                    free_element(live[index]);                                                           \
+                    live[index] = live[--live_count];                                                    \
+                }                                                                                        \
+            }                                                                                            \
+            while (live_count) { free_element(live[--live_count]); }                                     \
+        });                                                                                              \
+    } while (0)
+
+#define BURST(ns, alloc, free_element) do {                                                              \
+        bench(ns, BURST_SIZE * BURST_COUNT * 2, {                                                        \
+            for (int burst = 0; burst < BURST_COUNT; burst++) {                                          \
+                for (int i = 0; i < BURST_SIZE; i++) {                                                   \
+                    u64* element = alloc;                                                                \
+                    element[0] = i;                                                                      \
+                    live[i] = element;                                                                   \
+                }                                                                                        \
+                for (int i = BURST_SIZE - 1; i >= 0; i--) {                                              \
+                    sum += *(u64*)live[i];                                                               \
+                    free_element(live[i]);                                                               \
+                }                                                                                        \
+            }                                                                                            \
+        });                                                                                              \
+    } while (0)
+
+static memory_pool bench_pool;
+static void bench_pool_free(void* element) { pool_free(&bench_pool, element); }
+
+static void compare(char* name, double pool_ns, double malloc_ns) {
+    printf("  %-32s pool %8.2f ns/op   malloc %8.2f ns/op   %5.2fx\n", name, pool_ns, malloc_ns, malloc_ns / pool_ns);
+    check_message(pool_ns < malloc_ns, "%s: the pool takes %.2f ns/op, malloc %.2f", name, pool_ns, malloc_ns);
+}
+
+static void bench_churn(char* name, u32 element_size, u32 alignment) {
+    arena_marker marker = save_arena(&test_arena);
+    void** live = push_array(&test_arena, void*, BURST_SIZE);
+    u64 sum = 0;
+    double pool_ns, malloc_ns;
+    
+    init_pool(&bench_pool, &test_arena, element_size, alignment, 1024);
+    CHURN(pool_ns, pool_alloc(&bench_pool), bench_pool_free);
+    CHURN(malloc_ns, malloc(element_size), free);
+    
+    char label[64];
+    sprintf(label, "churn, %u bytes", element_size);
+    compare(label, pool_ns, malloc_ns);
+    
+    BURST(pool_ns, pool_alloc(&bench_pool), bench_pool_free);
+    BURST(malloc_ns, malloc(element_size), free);
+    
+    sprintf(label, "bursts, %u bytes", element_size);
+    compare(label, pool_ns, malloc_ns);
+    
+    printf("  %s pool: %u elements of capacity for %d live at most\n", name, bench_pool.capacity, BURST_SIZE);
+    
+    test_sink += sum;
+    restore_arena(marker);
+}
+
+int main() {
+    u64 arena_size = megabytes(256);
+    init_arena(&test_arena, arena_size, malloc(arena_size));
+    
+    test_pool_basics();
+    
+    bench_churn("element_64", sizeof(element_64), _Alignof(element_64));
+    bench_churn("element_256", sizeof(element_256), _Alignof(element_256));
+    
+    return test_finish("pool");
+}
@@ -0,0 +1,242 @@
+// @Info: get_part_at_mouse used to test the ray against the six quads of every part, now it does one slab test per
+//        part with intersect_ray_boxes. This keeps a copy of the quad version and checks on random ships that both
+//        pick the same part, at the same distance, on the same face, and how much faster the boxes are.
+
+#include "test.h"
+#include "../source/game_module.c"
+
+#define SCENE_COUNT 400
+#define RAYS_PER_SCENE 256
+
+// @Note: both compute the distance in floats but in a different order
+#define DISTANCE_EPSILON 1e-4f
+
+typedef struct {
+    vec3 a, b;
+} collision_quad;
+
+// @Note: +x, +y, +z, -x, -y, -z
+static collision_quad cube_collision_quads[6] = {
+    { .a = { 0.5, -.5, -.5 }, .b = { 0.5, 0.5, 0.5 } },
+    { .a = { -.5, 0.5, -.5 }, .b = { 0.5, 0.5, 0.5 } },
+    { .a = { -.5, -.5, 0.5 }, .b = { 0.5, 0.5, 0.5 } },
+    { .a = { -.5, -.5, 0.5 }, .b = { -.5, 0.5, -.5 } },
+    { .a = { -.5, -.5, -.5 }, .b = { 0.5, -.5, 0.5 } },
+    { .a = { -.5, -.5, -.5 }, .b = { 0.5, 0.5, -.5 } },
+};
+
+static vec3 cube_collision_normals[6] = {
+    { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { -1, 0, 0 }, { 0, -1, 0 }, { 0, 0, -1 },
+};
+
+static float intersect_ray_plane(vec3 ray_origin, vec3 ray_dir, vec3 plane_origin, vec3 plane_normal) {
+    float dot = vec_dot(ray_dir, plane_normal);
+    if (ABS(dot) == 0) { return -1.; }
+    
+    return vec_dot(vec_sub(plane_origin, ray_origin), plane_normal) / dot;
+}
+
+// @Info: what game.c had, the ray against the plane of the quad and then the hit point against its corners
+static float intersect_ray_quad(vec3 ray_origin, vec3 ray_dir, collision_quad quad) {
+    vec3 plane_normal = quad.a.x == quad.b.x ? vec3(1, 0, 0) :
+                        quad.a.y == quad.b.y ? vec3(0, 1, 0) :
+                        vec3(0, 0, 1);
+    
+    float distance_to_plane = intersect_ray_plane(ray_origin, ray_dir, quad.a, plane_normal);
+    vec3 intersection = vec_add(vec_mul(ray_dir, distance_to_plane), ray_origin);
+    
+    bool in_quad = true;
+    for (int axis = 0; axis < 3; axis++) {
+        if (plane_normal.elements[axis] == 1.f) { continue; }
+        
+        float min = MIN(quad.a.elements[axis], quad.b.elements[axis]);
+        float max = MAX(quad.a.elements[axis], quad.b.elements[axis]);
+        in_quad = in_quad && min <= intersection.elements[axis] && intersection.elements[axis] <= max;
+    }
+    
+    return in_quad ? distance_to_plane : -1;
+}
+
+typedef struct {
+    vec3* positions;
+    int count;
+    ray_box_batch boxes;
+} test_scene;
+
+static ray_box_hit pick_with_quads(test_scene* scene, vec3 origin, vec3 dir, float max_distance) {
+    ray_box_hit result = { .index = -1, .distance = max_distance };
+    
+    for (int i = 0; i < scene->count; i++) {
+        for (int q = 0; q < 6; q++) {
+            collision_quad quad = cube_collision_quads[q];
+            quad.a = vec_add(quad.a, scene->positions[i]);
+            quad.b = vec_add(quad.b, scene->positions[i]);
+            
+            float d = intersect_ray_quad(origin, dir, quad);
+            if (d >= 0 && d < result.distance) {
+                result = (ray_box_hit) { .index = i, .distance = d, .normal = cube_collision_normals[q] };
+            }
+        }
+    }
+    
+    return result;
+}
+
+// @Info: a random ship like the editor makes them, parts on distinct cells around a ship position that is not on
+//        the grid. The boxes get filled the way get_part_at_mouse fills them.
+static test_scene make_scene(int count) {
+    test_scene scene = { .count = count };
+    scene.positions = malloc(count * sizeof(vec3));
+    
+    int capacity = ray_box_batch_capacity(count);
+    float* data = calloc(6 * capacity, sizeof(float));
+    scene.boxes = (ray_box_batch) {
+        .min_x = data,                .min_y = data + capacity,     .min_z = data + 2 * capacity,
+        .max_x = data + 3 * capacity, .max_y = data + 4 * capacity, .max_z = data + 5 * capacity,
+        .count = count,
+    };
+    
+    vec3 ship_position = vec3(test_random_float(-3, 3), test_random_float(-3, 3), test_random_float(-3, 3));
+    
+    for (int i = 0; i < count; i++) {
+        ivec3 cell;
+        bool taken = true;
+        while (taken) {
+            cell = ivec3(test_random_int(-6, 6), test_random_int(-6, 6), test_random_int(-6, 6));
+            taken = false;
+            for (int j = 0; j < i && !taken; j++) {
+                vec3 other = vec_sub(scene.positions[j], ship_position);
+                taken = other.x == cell.x && other.y == cell.y && other.z == cell.z;
+            }
+        }
+        
+        vec3 p = vec_add(vec3(cell.x, cell.y, cell.z), ship_position);
+        scene.positions[i] = p;
+        
+        scene.boxes.min_x[i] = p.x - .5f; scene.boxes.max_x[i] = p.x + .5f;
+        scene.boxes.min_y[i] = p.y - .5f; scene.boxes.max_y[i] = p.y + .5f;
+        scene.boxes.min_z[i] = p.z - .5f; scene.boxes.max_z[i] = p.z + .5f;
+    }
+    
+    return scene;
+}
+
+static void free_scene(test_scene* scene) {
+    free(scene->positions);
+    free(scene->boxes.min_x);
+}
+
+static vec3 random_direction() {
+    vec3 result;
+    do {
+        result = vec3(test_random_float(-1, 1), test_random_float(-1, 1), test_random_float(-1, 1));
+    } while (vec_dot(result, result) < 0.01f || vec_dot(result, result) > 1);
+    
+    return vec_norm(result);
+}
+
+// @Info: mostly a camera outside of the ship looking at some point of it, some rays start inside it and some go
+//        straight along an axis, where the other two components of the direction are exactly zero
+static void make_ray(vec3* origin, vec3* dir) {
+    vec3 target = vec3(test_random_float(-8, 8), test_random_float(-8, 8), test_random_float(-8, 8));
+    
+    switch (test_random_int(0, 7)) {
+        case 0: {
+            *origin = target;
+            *dir = random_direction();
+        } break;
+        case 1: {
+            int axis = test_random_int(0, 2);
+            *dir = vec3(0, 0, 0);
+            dir->elements[axis] = test_random_int(0, 1) ? 1 : -1;
+            *origin = vec_sub(target, vec_mul(*dir, 30));
+        } break;
+        default: {
+            *origin = vec_add(target, vec_mul(random_direction(), test_random_float(15, 40)));
+            *dir = vec_norm(vec_sub(target, *origin));
+        } break;
+    }
+}
+
+static float distance_to_part(test_scene* scene, int index, vec3 origin, vec3 dir) {
+    test_scene one = { .positions = &scene->positions[index], .count = 1 };
+    return pick_with_quads(&one, origin, dir, 100).distance;
+}
+
+static void test_random_picks() {
+    int hits = 0, grazes = 0, rays = 0;
+    
+    for (int round = 0; round < SCENE_COUNT; round++) {
+        test_scene scene = make_scene(test_random_int(1, 300));
+        
+        for (int r = 0; r < RAYS_PER_SCENE; r++) {
+            vec3 origin, dir;
+            make_ray(&origin, &dir);
+            
+            ray_box_hit expected = pick_with_quads(&scene, origin, dir, 100);
+            ray_box_hit hit = intersect_ray_boxes(origin, dir, scene.boxes, 100);
+            rays++;
+            
+            if (hit.index == expected.index) {
+                if (hit.index < 0) { continue; }
+                hits++;
+                
+                check_message(ABS(hit.distance - expected.distance) <= DISTANCE_EPSILON,
+                              "round %d, ray %d: part %d at %f, the quads say %f", round, r, hit.index, hit.distance, expected.distance);
+                check_message(vec_dot(hit.normal, expected.normal) == 1,
+                              "round %d, ray %d: part %d hit on face (%g, %g, %g), the quads say (%g, %g, %g)", round, r, hit.index,
+                              hit.normal.x, hit.normal.y, hit.normal.z, expected.normal.x, expected.normal.y, expected.normal.z);
+                continue;
+            }
+            
+            // @Note: a ray that grazes an edge or a corner can end up on either side of it in floats, that is only
+            //        fine if the part the boxes picked is as close as what the quads picked
+            float picked = hit.index >= 0 ? distance_to_part(&scene, hit.index, origin, dir) : 100;
+            bool graze = hit.index >= 0 && ABS(hit.distance - expected.distance) <= DISTANCE_EPSILON && ABS(picked - hit.distance) <= DISTANCE_EPSILON;
+            check_message(graze, "round %d, ray %d: picked part %d at %f, the quads picked %d at %f",
+                          round, r, hit.index, hit.distance, expected.index, expected.distance);
+            grazes += graze;
+        }
+        
+        free_scene(&scene);
+    }
+    
+    printf("  %d rays, %d hit a part, %d grazed an edge\n", rays, hits, grazes);
+    
+    // @Note: the ships are sparse, but a good part of the rays has to hit something or this only compares misses
+    check(hits > rays / 3);
+}
+
+static void bench_picks() {
+    test_scene scene = make_scene(SHIP_PART_MAX_COUNT);
+    
+    vec3 origins[RAYS_PER_SCENE], dirs[RAYS_PER_SCENE];
+    for (int r = 0; r < RAYS_PER_SCENE; r++) { make_ray(&origins[r], &dirs[r]); }
+    
+    double boxes_ns, quads_ns;
+    float sum = 0;
+    
+    bench(boxes_ns, RAYS_PER_SCENE, for (int r = 0; r < RAYS_PER_SCENE; r++) {
+        sum += intersect_ray_boxes(origins[r], dirs[r], scene.boxes, 100).distance;
+    });
+    bench(quads_ns, RAYS_PER_SCENE, for (int r = 0; r < RAYS_PER_SCENE; r++) {
+        sum += pick_with_quads(&scene, origins[r], dirs[r], 100).distance;
+    });
+    test_sink += sum;
+    
+    report_time("pick 512 parts with quads", quads_ns);
+    check_time("pick 512 parts with boxes", boxes_ns, 10000);
+    printf("  boxes are %.1fx as fast\n", quads_ns / boxes_ns);
+    check_message(boxes_ns < quads_ns, "the boxes took %.2f ns per pick, the quads %.2f", boxes_ns, quads_ns);
+    
+    free_scene(&scene);
+}
+
+int main() {
+    printf("ray picking, %s\n", VECTOR_SIMD_AVX2 ? "AVX2" : VECTOR_SIMD_SSE ? "SSE" : "no simd in this build");
+    
+    test_random_picks();
+    bench_picks();
+    
+    return test_finish("ray_pick");
+}
@@ -0,0 +1,223 @@
+// @Info: the part graph of ships.c on ships far bigger than SHIP_PART_MAX_COUNT. Checks the adjacency that
+//        ship_graph_add_part/ship_graph_remove_part keep up against a rebuild, and the island count against a
+//        plain flood fill, then measures deleting parts from 100k part ships the way delete_part_at_mouse does.
+
+#include "test.h"
+#include "../source/game_module.c"
+
+#define BIG_SHIP_PART_COUNT 100000
+
+static memory_arena test_arena;
+
+typedef struct {
+    ship_graph graph;
+    ship_part* parts;
+    u32 part_count;
+    u32 capacity;
+} test_ship;
+
+static test_ship make_test_ship(u32 capacity) {
+    test_ship result = { .capacity = capacity };
+    result.graph = make_ship_graph(&test_arena, capacity);
+    result.parts = push_array_zero(&test_arena, ship_part, capacity);
+    return result;
+}
+
+static void test_ship_add(test_ship* ship, ivec3 cell) {
+    assert(ship->part_count < ship->capacity);
+    u32 index = ship->part_count++;
+    
+    ship->parts[index] = (ship_part) { .x = cell.x, .y = cell.y, .z = cell.z, .active = true };
+    ship_graph_add_part(&ship->graph, cell, index);
+}
+
+static void test_ship_remove(test_ship* ship, u32 index) {
+    ship_graph_remove_part(&ship->graph, ship_part_cell(&ship->parts[index]), index);
+    ship->parts[index].active = false;
+}
+
+// @Info: 50 x 50 x 40 blocks
+static void make_solid_ship(test_ship* ship) {
+    for (int x = -25; x < 25; x++) for (int y = -25; y < 25; y++) for (int z = -20; z < 20; z++) {
+        test_ship_add(ship, ivec3(x, y, z));
+    }
+}
+
+// @Info: a spine of 1000 parts along x with a tooth of 198 parts going up from every second one. Deleting the spine
+//        or anything in a tooth but its tip cuts something off, so these are the deletes that have to search.
+//        The spine comes first, part x of it has index x.
+static void make_comb_ship(test_ship* ship) {
+    for (int x = 0; x < 1000; x++) { test_ship_add(ship, ivec3(x - 500, 0, 0)); }
+    
+    for (int x = 0; x < 1000; x += 2) for (int y = 1; y < 199; y++) {
+        test_ship_add(ship, ivec3(x - 500, y, 0));
+    }
+}
+
+// @Info: flood fills from every neighbor of part_index without going through it, the neighbors end up in some
+//        number of pieces and all but one of them would be cut off
+static int reference_count_islands_without(test_ship* ship, u32 part_index, u32* stack, u32* piece) {
+    for (u32 i = 0; i < ship->part_count; i++) { piece[i] = 0; }
+    piece[part_index] = SHIP_GRAPH_NO_PART;
+    
+    int piece_count = 0;
+    for (int start_direction = 0; start_direction < 6; start_direction++) {
+        u32 start = ship->graph.neighbors[part_index][start_direction];
+        if (start == SHIP_GRAPH_NO_PART || piece[start]) { continue; }
+        
+        piece_count++;
+        u32 stack_count = 0;
+        stack[stack_count++] = start;
+        piece[start] = piece_count;
+        
+        while (stack_count) {
+            u32 current = stack[--stack_count];
+            ivec3 cell = ship_part_cell(&ship->parts[current]);
+            
+            for (int d = 0; d < 6; d++) {
+                u32 neighbor = ship_graph_find_cell(&ship->graph, vec_add(cell, ship_graph_directions[d]));
+                if (neighbor == SHIP_GRAPH_NO_PART || piece[neighbor]) { continue; }
+                
+                piece[neighbor] = piece_count;
+                stack[stack_count++] = neighbor;
+            }
+        }
+    }
+    
+    return MAX(piece_count - 1, 0);
+}
+
+static bool graph_matches_rebuild(test_ship* ship) {
+    ship_graph rebuilt = make_ship_graph(&test_arena, ship->capacity);
+    ship_graph_rebuild(&rebuilt, ship->parts, ship->part_count);
+    
+    for (u32 i = 0; i < ship->part_count; i++) {
+        if (!ship->parts[i].active) { continue; }
+        if (memcmp(rebuilt.neighbors[i], ship->graph.neighbors[i], sizeof(ship_graph_neighbors))) { return false; }
+    }
+    
+    return true;
+}
+
+static void test_cell_keys() {
+    arena_marker marker = save_arena(&test_arena);
+    test_ship ship = make_test_ship(64);
+    
+    // @Note: the corners of the s16 range, with the old 10 bit keys all of these landed on the same few cells
+    ivec3 cells[] = {
+        { -32768, -32768, -32768 }, { 32767, 32767, 32767 }, { -32768, 32767, 0 }, { 0, 0, 0 },
+        { 512, 0, 0 }, { -512, 0, 0 }, { 1024, 1024, 1024 }, { 0, 0, 1024 }, { 0, 1, 0 }, { 1, 0, 0 },
+    };
+    
+    for (int i = 0; i < array_count(cells); i++) { test_ship_add(&ship, cells[i]); }
+    for (int i = 0; i < array_count(cells); i++) {
+        check_message(ship_graph_find_cell(&ship.graph, cells[i]) == (u32)i, "cell %d, %d, %d", cells[i].x, cells[i].y, cells[i].z);
+    }
+    
+    check(ship.graph.neighbors[3][0] == 9); // @Note: (1, 0, 0) is +x of (0, 0, 0)
+    check(ship.graph.neighbors[3][2] == 8);
+    check(ship.graph.neighbors[0][1] == SHIP_GRAPH_NO_PART);
+    
+    restore_arena(marker);
+}
+
+// @Info: random blobs, after every removal the graph has to match a rebuild and the island count a flood fill
+static void test_random_ships() {
+    arena_marker marker = save_arena(&test_arena);
+    
+    u32* stack = push_array(&test_arena, u32, 4096);
+    u32* piece = push_array(&test_arena, u32, 4096);
+    
+    for (int round = 0; round < 20; round++) {
+        test_ship ship = make_test_ship(4096);
+        
+        ivec3 cell = { 0 };
+        while (ship.part_count < 2000) {
+            if (ship_graph_find_cell(&ship.graph, cell) == SHIP_GRAPH_NO_PART) { test_ship_add(&ship, cell); }
+            cell = vec_add(cell, ship_graph_directions[test_random_int(0, 5)]);
+        }
+        
+        for (int removal = 0; removal < 400; removal++) {
+            u32 index = test_random_int(0, ship.part_count - 1);
+            if (!ship.parts[index].active) { continue; }
+            
+            int islands = ship_graph_count_islands_without(&ship.graph, index);
+            int expected = reference_count_islands_without(&ship, index, stack, piece);
+            check_message(islands == expected, "round %d, part %u: %d islands, the flood fill found %d", round, index, islands, expected);
+            
+            // @Note: the flood fill does not care about splitting, so the graph also gets to see ships in pieces
+            test_ship_remove(&ship, index);
+        }
+        
+        check_message(graph_matches_rebuild(&ship), "round %d: the graph differs from a rebuilt one", round);
+    }
+    
+    restore_arena(marker);
+}
+
+// @Info: tries to delete random parts like delete_part_at_mouse, deleting the ones that leave the ship in one piece
+static void bench_deletes(char* name, void (*make_ship)(test_ship*), int attempt_count, double limit_ns) {
+    arena_marker marker = save_arena(&test_arena);
+    
+    test_ship ship = make_test_ship(BIG_SHIP_PART_COUNT);
+    make_ship(&ship);
+    check(ship.part_count == BIG_SHIP_PART_COUNT);
+    
+    u32* attempts = push_array(&test_arena, u32, attempt_count);
+    for (int i = 0; i < attempt_count; i++) { attempts[i] = test_random_int(0, ship.part_count - 1); }
+    
+    int deleted = 0;
+    double start = test_seconds();
+    for (int i = 0; i < attempt_count; i++) {
+        u32 index = attempts[i];
+        if (!ship.parts[index].active) { continue; }
+        if (ship_graph_count_islands_without(&ship.graph, index)) { continue; }
+        
+        test_ship_remove(&ship, index);
+        deleted++;
+    }
+    double ns = (test_seconds() - start) * 1e9 / attempt_count;
+    
+    printf("  %s: %d of %d deletes went through\n", name, deleted, attempt_count);
+    check_time(name, ns, limit_ns);
+    check_message(graph_matches_rebuild(&ship), "%s: the graph differs from a rebuilt one", name);
+    
+    restore_arena(marker);
+}
+
+// @Info: every part of the comb spine but the ends cuts the ship in two, the search has to go through the smaller
+//        side to find that out, so this is the worst case for a refused delete
+static void bench_spine_deletes(double limit_ns) {
+    arena_marker marker = save_arena(&test_arena);
+    
+    test_ship ship = make_test_ship(BIG_SHIP_PART_COUNT);
+    make_comb_ship(&ship);
+    
+    int attempt_count = 200;
+    int refused = 0;
+    double start = test_seconds();
+    for (int i = 0; i < attempt_count; i++) {
+        u32 index = test_random_int(1, 998);
+        if (ship_graph_count_islands_without(&ship.graph, index)) { refused++; }
+    }
+    double ns = (test_seconds() - start) * 1e9 / attempt_count;
+    
+    check(refused == attempt_count);
+    check_time("refused delete from comb spine", ns, limit_ns);
+    
+    restore_arena(marker);
+}
+
+int main() {
+    u64 arena_size = megabytes(256);
+    init_arena(&test_arena, arena_size, malloc(arena_size));
+    
+    test_cell_keys();
+    test_random_ships();
+    
+    bench_deletes("delete from solid 100k ship", make_solid_ship, 20000, 2500);
+    bench_deletes("delete from comb 100k ship", make_comb_ship, 20000, 40000);
+    bench_spine_deletes(3000000);
+    
+    return test_finish("ship_graph");
+}
@@ -0,0 +1,222 @@
+// @Info: the string_builder of string.c. Random appends and prepends, from a few bytes to a few megabytes, have to
+//        flush to exactly what plain concatenation gives, with a malloc/free allocator and with an arena like one
+//        that never frees. Then how fast it builds a 64MB obj-like file from small pieces, next to the builder it
+//        replaced and a buffer that grows with realloc.
+//
+//        The old builder only pointed at the pieces, so its callers had to keep each one alive until the flush. In
+//        the game that meant formatting them onto the transient arena, the benchmark copies them onto the arena for it.
+
+#include "test.h"
+#include "../source/vector.c"
+#include "../source/string.c"
+
+#define BENCH_OUTPUT_SIZE (64 * 1024 * 1024)
+#define BENCH_PIECE_COUNT 4096
+
+// @Info: an arena stand-in, pushes onto one big block and never frees
+static char* bump_memory;
+static size_t bump_used, bump_size;
+
+static void* bump_allocate(size_t size) {
+    size = (size + 15) & ~(size_t)15;
+    if (bump_used + size > bump_size) { return 0; }
+    
+    void* result = bump_memory + bump_used;
+    bump_used += size;
+    return result;
+}
+
+// @Info: the builder before the chunks, one node per piece that only points at it. Everything is on the arena.
+typedef struct old_builder_node {
+    char* data;
+    unsigned int length;
+    struct old_builder_node* next;
+} old_builder_node;
+
+typedef struct {
+    old_builder_node* front;
+    old_builder_node* end;
+    unsigned int total_length;
+} old_builder;
+
+static void old_builder_append(old_builder* builder, string str) {
+    old_builder_node* node = bump_allocate(sizeof(old_builder_node));
+    node->data = str.data;
+    node->length = str.length;
+    node->next = 0;
+    
+    if (!builder->end) { builder->end = builder->front = node; }
+    else               { builder->end->next = node; builder->end = node; }
+    
+    builder->total_length += str.length;
+}
+
+static string old_builder_flush(old_builder* builder) {
+    string result = { .data = bump_allocate(builder->total_length + 1), .length = builder->total_length };
+    
+    unsigned int current_length = 0;
+    old_builder_node* node = builder->front;
+    while (node) {
+        memory_copy(result.data + current_length, node->data, node->length);
+        current_length += node->length;
+        node = node->next;
+    }
+    result.data[current_length] = 0;
+    
+    *builder = (old_builder) { 0 };
+    return result;
+}
+
+static void fill_random(char* data, unsigned int length) {
+    for (unsigned int i = 0; i < length; i++) { data[i] = 'a' + test_random_int(0, 25); }
+}
+
+// @Info: the expected output is kept as the prepended pieces (newest first) and the appended ones, in two buffers
+static void test_random_builds(char* name, string_builder builder, int round_count) {
+    unsigned int max_size = 16 * 1024 * 1024;
+    char* front = malloc(max_size);
+    char* back = malloc(max_size);
+    char* piece = malloc(4 * 1024 * 1024);
+    
+    for (int round = 0; round < round_count; round++) {
+        unsigned int front_length = 0, back_length = 0;
+        int piece_count = test_random_int(0, 3000);
+        
+        for (int i = 0; i < piece_count; i++) {
+            unsigned int length;
+            switch (test_random_int(0, 99)) {
+                case 0:  length = test_random_int(1024 * 1024 / 2, 3 * 1024 * 1024); break;
+                case 1:  length = test_random_int(4 * 1024, 64 * 1024); break;
+                case 2:  length = 0; break;
+                default: length = test_random_int(1, 100); break;
+            }
+            if (front_length + back_length + length > max_size / 2) { break; }
+            
+            fill_random(piece, length);
+            
+            if (test_random_int(0, 49) == 0) {
+                string_builder_append_front(&builder, string(piece, length));
+                memmove(front + length, front, front_length);
+                memcpy(front, piece, length);
+                front_length += length;
+            } else {
+                string_builder_append(&builder, string(piece, length));
+                memcpy(back + back_length, piece, length);
+                back_length += length;
+            }
+            
+            // @Note: the builder has to have copied the piece, the caller can reuse it right away
+            memset(piece, '#', length);
+        }
+        
+        unsigned int length = front_length + back_length;
+        check_message(builder.total_length == length, "%s, round %d: total_length %u, %u went in", name, round, builder.total_length, length);
+        
+        string result = string_builder_flush(&builder);
+        bool same = result.length == length && result.data[length] == 0 &&
+            memcmp(result.data, front, front_length) == 0 && memcmp(result.data + front_length, back, back_length) == 0;
+        check_message(same, "%s, round %d: %u pieces, %u bytes, the flushed string differs", name, round, piece_count, length);
+        
+        check(builder.front == 0 && builder.end == 0 && builder.total_length == 0 && builder.chunk_count == 0);
+        
+        if (builder.free) { free(result.data); }
+    }
+    
+    free(front);
+    free(back);
+    free(piece);
+}
+
+// @Info: "v x y z\n" lines, formatted once up front so the benchmark only measures the builders
+static void bench_build() {
+    char* pieces = malloc(BENCH_PIECE_COUNT * 64);
+    string piece_strings[BENCH_PIECE_COUNT];
+    
+    for (int i = 0; i < BENCH_PIECE_COUNT; i++) {
+        char* text = pieces + i * 64;
+        int length = sprintf(text, "v %.6f %.6f %.6f\n", test_random_float(-100, 100), test_random_float(-100, 100), test_random_float(-100, 100));
+        piece_strings[i] = string(text, length);
+    }
+    
+    // @Note: as many pieces as it takes to get just past BENCH_OUTPUT_SIZE
+    int piece_count = 0;
+    for (unsigned int length = 0; length < BENCH_OUTPUT_SIZE; piece_count++) { length += piece_strings[piece_count % BENCH_PIECE_COUNT].length; }
+    
+    double builder_ns, arena_ns, old_ns, realloc_ns;
+    unsigned int output_length = 0;
+    double sum = 0;
+    
+    bench(builder_ns, 1, {
+        string_builder builder = make_string_builder(malloc, free);
+        for (int i = 0; i < piece_count; i++) { _string_builder_append(&builder, piece_strings[i % BENCH_PIECE_COUNT]); }
+        string result = string_builder_flush(&builder);
+        output_length = result.length;
+        sum += result.data[result.length / 2];
+        free(result.data);
+    });
+    
+    bench(arena_ns, 1, {
+        bump_used = 0;
+        string_builder builder = make_string_builder(bump_allocate, 0);
+        for (int i = 0; i < piece_count; i++) { _string_builder_append(&builder, piece_strings[i % BENCH_PIECE_COUNT]); }
+        string result = string_builder_flush(&builder);
+        sum += result.data[result.length / 2];
+    });
+    
+    bench(old_ns, 1, {
+        bump_used = 0;
+        old_builder builder = { 0 };
+        for (int i = 0; i < piece_count; i++) {
+            string piece = piece_strings[i % BENCH_PIECE_COUNT];
+            string kept = { .data = bump_allocate(piece.length), .length = piece.length };
+            memcpy(kept.data, piece.data, piece.length);
+            old_builder_append(&builder, kept);
+        }
+        string result = old_builder_flush(&builder);
+        sum += result.data[result.length / 2];
+    });
+    
+    bench(realloc_ns, 1, {
+        unsigned int capacity = 4096, length = 0;
+        char* buffer = malloc(capacity);
+        for (int i = 0; i < piece_count; i++) {
+            string piece = piece_strings[i % BENCH_PIECE_COUNT];
+            if (length + piece.length > capacity) {
+                capacity *= 2;
+                buffer = realloc(buffer, capacity);
+            }
+            memcpy(buffer + length, piece.data, piece.length);
+            length += piece.length;
+        }
+        sum += buffer[length / 2];
+        free(buffer);
+    });
+    
+    test_sink += sum;
+    
+    printf("  %d pieces, %.1f MB\n", piece_count, output_length / 1e6);
+    report_throughput("string_builder, malloc", output_length, builder_ns * 1e-9);
+    report_throughput("string_builder, arena", output_length, arena_ns * 1e-9);
+    report_throughput("old builder, arena", output_length, old_ns * 1e-9);
+    report_throughput("realloc buffer", output_length, realloc_ns * 1e-9);
+    
+    double mb_per_second = output_length / (builder_ns * 1e-9) / 1e6;
+    check_message(mb_per_second >= 200, "string_builder only builds %.1f MB/s", mb_per_second);
+    check_message(arena_ns <= old_ns, "string_builder took %.1f ms on the arena, the old builder %.1f ms", arena_ns * 1e-6, old_ns * 1e-6);
+    
+    free(pieces);
+}
+
+int main() {
+    bump_size = 512 * 1024 * 1024;
+    bump_memory = malloc(bump_size);
+    
+    test_random_builds("malloc", make_string_builder(malloc, free), 40);
+    
+    bump_used = 0;
+    test_random_builds("arena", make_string_builder(bump_allocate, 0), 10);
+    
+    bench_build();
+    
+    return test_finish("string_builder");
+}
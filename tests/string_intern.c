@@ -0,0 +1,155 @@
+// @Info: the string intern pool of string.c. The same text has to give the same id and different texts different
+//        ids, also when the hash is bad: with every string on the same hash, and with hashes that differ but all start
+//        probing at the same slot. Then how fast interning new strings, interning known ones and looking up missing
+//        ones is with the real hash.
+
+#include "test.h"
+#include "../source/vector.c"
+
+typedef enum {
+    TEST_HASH_FNV,
+    TEST_HASH_CONSTANT,   // @Note: every string collides, lookups have to compare all of them
+    TEST_HASH_HIGH_BITS,  // @Note: the hashes differ but the slot bits are all zero, so they all probe from slot 0
+} test_hash_mode;
+
+static test_hash_mode test_hash = TEST_HASH_FNV;
+
+#define STRING_INTERN_HASH(str) test_string_hash((str).data, (str).length)
+static inline unsigned int test_string_hash(char* data, unsigned int length);
+
+#include "../source/string.c"
+
+static inline unsigned int test_string_hash(char* data, unsigned int length) {
+    switch (test_hash) {
+        case TEST_HASH_CONSTANT:  return 0x5bd1e995;
+        case TEST_HASH_HIGH_BITS: return string_hash(string(data, length)) << 20;
+        default:                  return string_hash(string(data, length));
+    }
+}
+
+#define STRING_MAX_LENGTH 24
+#define BENCH_STRING_COUNT 1000000
+
+typedef struct {
+    char text[STRING_MAX_LENGTH + 1];
+    unsigned int length;
+} test_string;
+
+// @Note: short names over a small alphabet, so plenty of them share prefixes or are prefixes of each other
+static void make_random_strings(test_string* strings, int count, int max_length) {
+    for (int i = 0; i < count; i++) {
+        strings[i].length = test_random_int(0, max_length);
+        for (unsigned int c = 0; c < strings[i].length; c++) { strings[i].text[c] = "ab_/.1"[test_random_int(0, 5)]; }
+        strings[i].text[strings[i].length] = 0;
+    }
+}
+
+static int find_text(test_string* strings, int count, test_string* text) {
+    for (int i = 0; i < count; i++) {
+        if (strings[i].length == text->length && memcmp(strings[i].text, text->text, text->length) == 0) { return i; }
+    }
+    return -1;
+}
+
+// @Info: interns random strings with lots of repeats into a pool that starts tiny, so it grows a few times on the way.
+//        The first string with a text decides the id every later one has to get.
+static void test_pool(char* name, test_hash_mode mode, int count) {
+    test_hash = mode;
+    
+    test_string* strings = malloc(count * sizeof(test_string));
+    string_id* ids = malloc(count * sizeof(string_id));
+    make_random_strings(strings, count, 8);
+    
+    string_intern_pool pool = make_string_intern_pool(malloc, 1);
+    
+    unsigned int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        // @Note: a copy, so a match has to come from comparing the text and not the pointer
+        test_string copy = strings[i];
+        ids[i] = string_intern(&pool, string(copy.text, copy.length));
+        memset(copy.text, '#', sizeof(copy.text));
+        
+        int first = find_text(strings, i, &strings[i]);
+        if (first < 0) {
+            distinct++;
+            check_message(ids[i] == distinct, "%s: new string \"%s\" got id %u, expected %u", name, strings[i].text, ids[i], distinct);
+        } else {
+            check_message(ids[i] == ids[first], "%s: \"%s\" got id %u, the first time it got %u", name, strings[i].text, ids[i], ids[first]);
+        }
+    }
+    
+    check_message(pool.count == distinct, "%s: %u strings in the pool, %u distinct ones went in", name, pool.count, distinct);
+    
+    for (int i = 0; i < count; i++) {
+        string text = string_from_id(&pool, ids[i]);
+        check_message(text.length == strings[i].length && memcmp(text.data, strings[i].text, text.length) == 0 && text.data[text.length] == 0,
+                      "%s: id %u gives \"%.*s\", it was \"%s\"", name, ids[i], (int)text.length, text.data, strings[i].text);
+        check(string_intern_find(&pool, string(strings[i].text, strings[i].length)) == ids[i]);
+    }
+    
+    // @Note: longer than anything that went in, so none of these can be in there
+    test_string missing[256];
+    make_random_strings(missing, 256, STRING_MAX_LENGTH);
+    for (int i = 0; i < 256; i++) {
+        if (missing[i].length <= 8) { continue; }
+        check_message(string_intern_find(&pool, string(missing[i].text, missing[i].length)) == STRING_ID_NONE,
+                      "%s: \"%s\" was never interned but has an id", name, missing[i].text);
+    }
+    
+    check(string_from_id(&pool, STRING_ID_NONE).data == 0);
+    check(string_from_id(&pool, pool.count + 1).data == 0);
+    
+    printf("  %-12s %d strings, %u distinct\n", name, count, distinct);
+    
+    free(strings);
+    free(ids);
+    test_hash = TEST_HASH_FNV;
+}
+
+static void bench_pool() {
+    test_string* strings = malloc(BENCH_STRING_COUNT * sizeof(test_string));
+    for (int i = 0; i < BENCH_STRING_COUNT; i++) {
+        // @Note: names like the ones the game interns, a path and a number so they are all distinct
+        strings[i].length = sprintf(strings[i].text, "%s/%07d.%s", (char*[]){ "shaders", "textures", "fonts" }[i % 3], i, i & 1 ? "glsl" : "png");
+    }
+    
+    double insert_ns, hit_ns, miss_ns;
+    string_id sum = 0;
+    
+    // @Note: every round needs an empty pool, the allocations of the old ones are left behind like in the game
+    bench(insert_ns, BENCH_STRING_COUNT, {
+        string_intern_pool pool = make_string_intern_pool(malloc, 64);
+        for (int i = 0; i < BENCH_STRING_COUNT; i++) { sum += string_intern(&pool, string(strings[i].text, strings[i].length)); }
+    });
+    
+    string_intern_pool pool = make_string_intern_pool(malloc, 64);
+    for (int i = 0; i < BENCH_STRING_COUNT; i++) { string_intern(&pool, string(strings[i].text, strings[i].length)); }
+    
+    bench(hit_ns, BENCH_STRING_COUNT, {
+        for (int i = 0; i < BENCH_STRING_COUNT; i++) { sum += string_intern(&pool, string(strings[i].text, strings[i].length)); }
+    });
+    
+    for (int i = 0; i < BENCH_STRING_COUNT; i++) { strings[i].text[0] = 'x'; }
+    bench(miss_ns, BENCH_STRING_COUNT, {
+        for (int i = 0; i < BENCH_STRING_COUNT; i++) { sum += string_intern_find(&pool, string(strings[i].text, strings[i].length)); }
+    });
+    
+    test_sink += sum;
+    check(pool.count == BENCH_STRING_COUNT);
+    
+    check_time("intern 1M new strings", insert_ns, 500);
+    check_time("intern 1M known strings", hit_ns, 300);
+    check_time("find 1M missing strings", miss_ns, 300);
+    
+    free(strings);
+}
+
+int main() {
+    test_pool("fnv", TEST_HASH_FNV, 20000);
+    test_pool("high bits", TEST_HASH_HIGH_BITS, 4000);
+    test_pool("constant", TEST_HASH_CONSTANT, 4000);
+    
+    bench_pool();
+    
+    return test_finish("string_intern");
+}
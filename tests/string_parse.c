@@ -0,0 +1,235 @@
+// @Info: string_eat_double against strtod. On random numbers, malformed ones and inf/nan with letters after them
+//        both have to give the same bits and consume the same number of characters. Then how fast each reads text
+//        like the numbers in an obj file.
+//
+//        Hex floats are left out, string_eat_double does not accept them on purpose. It also may not depend on the
+//        locale like strtod does, that gets checked under a locale with a ',' if there is one.
+
+#include "test.h"
+#include <locale.h>
+#include "../source/vector.c"
+#include "../source/string.c"
+
+#define RANDOM_INPUT_COUNT 2000000
+#define BENCH_NUMBER_COUNT 1000000
+
+static char* append_digits(char* p, int count) {
+    for (int i = 0; i < count; i++) { *p++ = '0' + test_random_int(0, 9); }
+    return p;
+}
+
+static char* append_text(char* p, char* text) {
+    while (*text) { *p++ = *text++; }
+    return p;
+}
+
+// @Info: a random number in any of the forms strtod takes, sometimes broken on purpose, followed by junk
+static int make_input(char* buffer) {
+    static char* specials[] = {
+        "inf", "INF", "infinity", "Infinity", "infinite", "infinityx", "infin", "nan", "NaN", "nanx", "nan(1)",
+        "i", "n", "in", "na", "index", "nope", "e5", ".", ".e1", "-", "+", "-.", "",
+    };
+    static char junk[] = " \t\n,;e.-+0123456789abcdefinEIN";
+    
+    char* p = buffer;
+    
+    int spaces = test_random_int(0, 7) == 0 ? test_random_int(1, 3) : 0;
+    for (int i = 0; i < spaces; i++) { *p++ = " \t\n\r\v\f"[test_random_int(0, 5)]; }
+    
+    switch (test_random_int(0, 3)) {
+        case 0: *p++ = '-'; break;
+        case 1: *p++ = '+'; break;
+    }
+    
+    int form = test_random_int(0, 15);
+    if (form == 0) {
+        p = append_text(p, specials[test_random_int(0, (int)(sizeof(specials) / sizeof(specials[0])) - 1)]);
+    } else if (form == 1) {
+        // @Note: an exact double, with exactly as many digits as it needs
+        union { unsigned long long bits; double value; } random_bits = { .bits = test_random() };
+        if (random_bits.value != random_bits.value || random_bits.value - random_bits.value != 0) { random_bits.value = 1; }
+        p += sprintf(p, "%.17g", ABS(random_bits.value));
+    } else {
+        int leading_zeros = test_random_int(0, 5) == 0 ? test_random_int(1, 5) : 0;
+        for (int i = 0; i < leading_zeros; i++) { *p++ = '0'; }
+        
+        // @Note: mostly short ones like in files, some long enough to be truncated
+        int integer_digits = test_random_int(0, 3) == 0 ? test_random_int(0, 40) : test_random_int(0, 6);
+        p = append_digits(p, integer_digits);
+        
+        if (test_random_int(0, 2)) {
+            *p++ = '.';
+            int fraction_digits = test_random_int(0, 3) == 0 ? test_random_int(0, 40) : test_random_int(0, 8);
+            p = append_digits(p, fraction_digits);
+        }
+        
+        if (test_random_int(0, 2) == 0) {
+            *p++ = test_random_int(0, 1) ? 'e' : 'E';
+            switch (test_random_int(0, 3)) {
+                case 0: *p++ = '-'; break;
+                case 1: *p++ = '+'; break;
+            }
+            
+            // @Note: mostly in range, then far outside of it and some without digits at all
+            switch (test_random_int(0, 7)) {
+                case 0:  break;
+                case 1:  p += sprintf(p, "%d", test_random_int(0, 400)); break;
+                case 2:  p = append_digits(p, test_random_int(1, 12)); break;
+                default: p += sprintf(p, "%d", test_random_int(0, 30)); break;
+            }
+        }
+    }
+    
+    int junk_count = test_random_int(0, 3);
+    for (int i = 0; i < junk_count; i++) { *p++ = junk[test_random_int(0, sizeof(junk) - 2)]; }
+    
+    *p = 0;
+    return (int)(p - buffer);
+}
+
+static bool same_double(double a, double b) {
+    if (a != a || b != b) { return a != a && b != b; }
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// @Info: parses the first length characters of text both ways. string_eat_double gets the rest of the text after it
+//        too, it may not read past length.
+static void compare_with_strtod(char* text, int length) {
+    char copy[1024];
+    memcpy(copy, text, length);
+    copy[length] = 0;
+    
+    char* end;
+    double expected = strtod(copy, &end);
+    int expected_eaten = (int)(end - copy);
+    
+    string str = string(text, length);
+    double result = string_eat_double(&str);
+    int eaten = length - (int)str.length;
+    
+    check_message(same_double(result, expected) && eaten == expected_eaten,
+                  "\"%s\": %.17g with %d characters eaten, strtod gives %.17g with %d", copy, result, eaten, expected, expected_eaten);
+}
+
+static void test_against_strtod() {
+    char buffer[256];
+    
+    for (int i = 0; i < RANDOM_INPUT_COUNT; i++) {
+        int length = make_input(buffer);
+        compare_with_strtod(buffer, length);
+        
+        // @Note: the same text cut off somewhere, what comes after is still in memory
+        if (length > 1) { compare_with_strtod(buffer, test_random_int(0, length - 1)); }
+    }
+    
+    char* cases[] = {
+        "infinity", "infinite", "infx", "nanometer", "index", "-inf,", "+nan)", "inFINITy1", "i", "",
+        "1e", "1e+", "1e-x", "1.e5", ".5", "5.", "00000000000000000000000000001",
+        "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497791e-308",
+        "2.4703282292062327e-324", "2.4703282292062328e-324", "4.9406564584124654e-324", "1e-400", "1e400",
+        "9007199254740993", "9007199254740992.5", "1.00000000000000011102230246251565404236316680908203125",
+    };
+    
+    for (int i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+        int length = (int)strlen(cases[i]);
+        if (length < 1024) { compare_with_strtod(cases[i], length); }
+    }
+    
+    // @Note: of a hex float only the 0 in front is a number
+    string hex = string("0x1p4");
+    check(string_eat_double(&hex) == 0 && hex.length == 4);
+}
+
+// @Info: the slow path calls strtod, which reads the radix character of LC_NUMERIC. Under a locale with a ',' the
+//        numbers that take it have to come out the same as in the C locale. Skipped if no such locale is installed.
+static void test_comma_locale() {
+    char* cases[] = {
+        "1.5e-70", "-1.5e-70x", "2.4703282292062327e-324", "1e400", "123456789012345678901234567890.5e-3",
+        "0.00000000000000000000000000000000000000000000000000000000000000000000000000000000000000123e+10",
+        "9007199254740992.5", "1.00000000000000011102230246251565404236316680908203125", "inf", "-nan(1)", "1,5",
+    };
+    int case_count = (int)(sizeof(cases) / sizeof(cases[0]));
+    
+    double expected[64];
+    unsigned int expected_length[64];
+    for (int i = 0; i < case_count; i++) {
+        string str = string(cases[i]);
+        expected[i] = string_eat_double(&str);
+        expected_length[i] = str.length;
+    }
+    
+    char* locales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "German", "French" };
+    char* locale = 0;
+    for (int i = 0; i < (int)(sizeof(locales) / sizeof(locales[0])) && !locale; i++) {
+        if (setlocale(LC_NUMERIC, locales[i]) && localeconv()->decimal_point[0] == ',') { locale = locales[i]; }
+    }
+    
+    if (!locale) {
+        setlocale(LC_NUMERIC, "C");
+        printf("  no locale with a ',' is installed, the locale check is skipped\n");
+        return;
+    }
+    
+    for (int i = 0; i < case_count; i++) {
+        string str = string(cases[i]);
+        double result = string_eat_double(&str);
+        check_message(same_double(result, expected[i]) && str.length == expected_length[i],
+                      "\"%s\" under %s: %.17g with %u left, %.17g with %u in the C locale", 
+                      cases[i], locale, result, str.length, expected[i], expected_length[i]);
+    }
+    
+    setlocale(LC_NUMERIC, "C");
+}
+
+// @Info: "%.6f" coordinates separated by spaces and line breaks, like the vertices of an obj file
+static void bench_parse() {
+    char* text = malloc(BENCH_NUMBER_COUNT * 16);
+    char* p = text;
+    for (int i = 0; i < BENCH_NUMBER_COUNT; i++) {
+        p += sprintf(p, "%.6f%c", test_random_float(-100, 100), i % 3 == 2 ? '\n' : ' ');
+    }
+    int length = (int)(p - text);
+    
+    double seconds, strtod_seconds;
+    double sum = 0;
+    int count = 0;
+    
+    bench(seconds, 1, {
+        string str = string(text, length);
+        count = 0;
+        while (str.length) {
+            unsigned int before = str.length;
+            sum += string_eat_double(&str);
+            if (str.length == before) { break; }
+            count++;
+        }
+    });
+    check(count == BENCH_NUMBER_COUNT);
+    
+    bench(strtod_seconds, 1, {
+        char* at = text;
+        for (int i = 0; i < BENCH_NUMBER_COUNT; i++) { sum += strtod(at, &at); }
+    });
+    test_sink += sum;
+    
+    // @Note: bench gives nanoseconds per op, with one op that is the whole run
+    seconds *= 1e-9;
+    strtod_seconds *= 1e-9;
+    
+    report_throughput("string_eat_double", length, seconds);
+    report_throughput("strtod", length, strtod_seconds);
+    
+    double mb_per_second = length / seconds / 1e6;
+    check_message(mb_per_second >= 100, "string_eat_double only reads %.1f MB/s", mb_per_second);
+    check_message(seconds <= strtod_seconds, "string_eat_double took %.3f s, strtod %.3f s", seconds, strtod_seconds);
+    
+    free(text);
+}
+
+int main() {
+    test_against_strtod();
+    test_comma_locale();
+    bench_parse();
+    
+    return test_finish("string_parse");
+}
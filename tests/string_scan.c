@@ -0,0 +1,303 @@
+// @Info: the scanning functions of string.c against the byte by byte loops they replaced. Random slices of text
+//        full of delimiters, with lengths around the 16 and 32 byte steps, have to give the same results and leave
+//        the string in the same place: string_eat_line, string_eat_token (also with white space delimiters and empty
+//        tokens), string_eat_to_first, string_after_first, string_until_first and string_count_occurence.
+//
+//        The old loops looked at the byte after the slice, so for them a slice is copied in front of a byte that is
+//        no delimiter. Every slice is also scanned where it ends right at a page that can not be read, the new
+//        functions must not touch it. Then how fast each walks an obj-like text line by line and token by token.
+
+// @Note: for MAP_ANONYMOUS, test.h only asks for POSIX
+#define _DEFAULT_SOURCE
+#include "test.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../source/vector.c"
+#include "../source/string.c"
+
+#define RANDOM_SLICE_COUNT 1000000
+#define MAX_SLICE_LENGTH 300
+#define BENCH_TEXT_SIZE (16 * 1024 * 1024)
+
+// === the loops from before string_find_char and string_count_char
+static inline void old_eat_white_spaces(string* str) {
+    while (is_white_space(str->data[0])) { string_increment(str); }
+}
+
+static int old_count_occurence(string str, char x) {
+    int count = 0;
+    for (int i = 0; i < (int)str.length; i++) {
+        if(str.data[i] == x) { count++; }
+    }
+    return count;
+}
+
+static string old_eat_to_first(string* str, char c) {
+    string result = { .data=str->data };
+    int length = str->length;
+    for (int i = 0; i < length; i++) {
+        if (str->data[0] == c) {
+            break;
+        }
+        
+        string_increment(str);
+        result.length++;
+    }
+    
+    return result;
+}
+
+static string old_after_first(string str, char c) {
+    string result = {0};
+    for (int i = 0; i < (int)str.length; i++) {
+        if (str.data[i] == c) {
+            result.data = str.data + i;
+            result.length = str.length - i;
+            result.size = result.length;
+            break;
+        }
+    }
+    
+    return result;
+}
+
+static string old_until_first(string str, char c) {
+    string result = {0};
+    for (int i = 0; i < (int)str.length; i++) {
+        if (str.data[i] == c) {
+            result.data = str.data;
+            result.length = i + 1; // include c
+            result.size = result.length;
+            break;
+        }
+    }
+    return result;
+}
+
+static string old_eat_line(string* str) {
+    string result = { .data=str->data };
+    
+    int max_length = str->length;
+    
+    while (str->data[0] != '\n' && (int)result.length < max_length) {
+        string_increment(str);
+        result.length++;
+    }
+    
+    if (str->data[0] == '\n') {
+        string_increment(str);
+    }
+    
+    result.size = result.length;
+    
+    return result;
+}
+
+static string old_eat_token(string* str, char delimit) {
+    if (!is_white_space(delimit)) {
+        old_eat_white_spaces(str);
+    }
+    
+    string result = { .data=str->data };
+    int length = str->length;
+    
+    for (int i = 0; i < length; i++) {
+        if (str->data[0] == delimit) {
+            string_increment(str); // remove delimiter
+            break;
+        }
+        
+        string_increment(str);
+        result.length++;
+    }
+    
+    result.size = result.length;
+    
+    return result;
+}
+
+// === comparing
+static char delimiters[] = { '\n', ' ', '\t', ',', '/', 'a' };
+
+static bool same_string(string a, string b) {
+    return a.data == b.data && a.length == b.length;
+}
+
+// @Info: base is where the slice is for the old loops, other is the same bytes somewhere else (at the end of a
+//        page or not). The results of the new functions on other are moved over to base before comparing.
+#define check_same(name, old, new_result, other, base)                                                           \
+    check_message(same_string(old, (string) { .data = (new_result).data ? (new_result).data - (other) + (base) : 0, .length = (new_result).length }), \
+                  "%s on \"%.*s\" (%u bytes): %u bytes at %ld, the old one %u bytes at %ld", name, (int)length, base, length,   \
+                  (new_result).length, (new_result).data ? (long)((new_result).data - (other)) : -1L,                       \
+                  (old).length, (old).data ? (long)((old).data - (base)) : -1L)
+
+static void compare_slice(char* base, char* other, unsigned int length) {
+    for (int d = 0; d < (int)sizeof(delimiters); d++) {
+        char c = delimiters[d];
+        string old_str = string(base, length), new_str = string(other, length);
+        
+        check_message(old_count_occurence(old_str, c) == string_count_occurence(new_str, c),
+                      "string_count_occurence of '%c' in %u bytes differs", c, length);
+        
+        string old_result = old_after_first(old_str, c);
+        string new_result = string_after_first(new_str, c);
+        check_same("string_after_first", old_result, new_result, other, base);
+        
+        old_result = old_until_first(old_str, c);
+        new_result = string_until_first(new_str, c);
+        check_same("string_until_first", old_result, new_result, other, base);
+        
+        old_result = old_eat_to_first(&old_str, c);
+        new_result = string_eat_to_first(&new_str, c);
+        check_same("string_eat_to_first", old_result, new_result, other, base);
+        check_same("string_eat_to_first, the rest", old_str, new_str, other, base);
+        
+        // @Note: token by token through the whole slice, that is where the empty tokens come from
+        old_str = string(base, length);
+        new_str = string(other, length);
+        for (int steps = 0; steps <= MAX_SLICE_LENGTH + 1 && (old_str.length || new_str.length); steps++) {
+            old_result = old_eat_token(&old_str, c);
+            new_result = string_eat_token(&new_str, c);
+            check_same("string_eat_token", old_result, new_result, other, base);
+            check_same("string_eat_token, the rest", old_str, new_str, other, base);
+            if (old_str.length != new_str.length) { break; }
+        }
+    }
+    
+    string old_str = string(base, length), new_str = string(other, length);
+    for (int steps = 0; steps <= MAX_SLICE_LENGTH + 1 && (old_str.length || new_str.length); steps++) {
+        string old_result = old_eat_line(&old_str);
+        string new_result = string_eat_line(&new_str);
+        check_same("string_eat_line", old_result, new_result, other, base);
+        check_same("string_eat_line, the rest", old_str, new_str, other, base);
+        if (old_str.length != new_str.length) { break; }
+    }
+}
+
+// @Info: mostly the lengths around the vector steps, a few zeros, everything else up to MAX_SLICE_LENGTH
+static unsigned int random_slice_length() {
+    static unsigned int interesting[] = { 0, 1, 15, 16, 17, 31, 32, 33, 47, 48, 63, 64, 65 };
+    if (test_random_int(0, 1)) { return interesting[test_random_int(0, (int)(sizeof(interesting) / sizeof(interesting[0])) - 1)]; }
+    return test_random_int(0, MAX_SLICE_LENGTH);
+}
+
+static void fill_random_text(char* data, unsigned int length) {
+    // @Note: sparse delimiters now and then, so the vector loops get to skip whole blocks
+    bool sparse = test_random_int(0, 3) == 0;
+    for (unsigned int i = 0; i < length; i++) {
+        if (sparse && test_random_int(0, 40)) { data[i] = 'x'; }
+        else                                  { data[i] = " \t\n,/a1.x"[test_random_int(0, 8)]; }
+    }
+}
+
+static void test_random_slices() {
+    long page_size = sysconf(_SC_PAGESIZE);
+    unsigned long guarded_size = (MAX_SLICE_LENGTH / page_size + 2) * page_size;
+    
+    // @Note: the last page can not be read, a slice ending at it faults on any read past its end
+    char* guarded = mmap(0, guarded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    check(guarded != MAP_FAILED);
+    if (guarded == MAP_FAILED) { return; }
+    char* guard = guarded + guarded_size - page_size;
+    mprotect(guard, page_size, PROT_NONE);
+    
+    char base[MAX_SLICE_LENGTH + 1];
+    
+    for (int i = 0; i < RANDOM_SLICE_COUNT; i++) {
+        unsigned int length = random_slice_length();
+        fill_random_text(base, length);
+        base[length] = 'x';
+        
+        // @Note: a missing trailing newline half of the time, and with one the last line is empty
+        if (length && test_random_int(0, 1)) { base[length - 1] = '\n'; }
+        
+        char* at_guard = guard - length;
+        memcpy(at_guard, base, length);
+        compare_slice(base, at_guard, length);
+    }
+    
+    munmap(guarded, guarded_size);
+}
+
+// @Info: what changed on purpose: the old loops read the byte after the slice and acted on it
+static void test_slice_ends() {
+    // @Note: a line that ends right where a '\n' follows in memory does not eat that '\n'
+    char text[] = "abc\ndef\nghi\n";
+    string str = string(text, 7);
+    string line = string_eat_line(&str);
+    check(line.length == 3 && str.length == 3);
+    line = string_eat_line(&str);
+    check(line.length == 3 && line.data == text + 4 && str.length == 0 && str.data == text + 7);
+    
+    char spaces[] = "      x";
+    str = string(spaces, 3);
+    string_eat_white_spaces(&str);
+    check(str.length == 0 && str.data == spaces + 3);
+    
+    // @Note: white space delimiters give empty tokens, others skip the white space in front of the token
+    str = string("a  b");
+    string token = string_eat_token(&str, ' ');
+    check(token.length == 1 && str.length == 2);
+    token = string_eat_token(&str, ' ');
+    check(token.length == 0 && str.length == 1);
+    
+    str = string("  a,,b");
+    token = string_eat_token(&str, ',');
+    check(token.length == 1 && token.data[0] == 'a');
+    token = string_eat_token(&str, ',');
+    check(token.length == 0);
+    token = string_eat_token(&str, ',');
+    check(token.length == 1 && token.data[0] == 'b' && str.length == 0);
+}
+
+// @Info: "v x y z" lines, read the way the obj loader does: line by line, then the line token by token
+static void bench_walk() {
+    char* text = malloc(BENCH_TEXT_SIZE + 64);
+    unsigned int length = 0;
+    while (length < BENCH_TEXT_SIZE) {
+        length += sprintf(text + length, "v %.6f %.6f %.6f\n", test_random_float(-100, 100), test_random_float(-100, 100), test_random_float(-100, 100));
+    }
+    text[length] = 'x';
+    
+    double new_ns, old_ns, count_ns, old_count_ns;
+    unsigned int sum = 0;
+    
+    bench(new_ns, 1, {
+        string str = string(text, length);
+        while (str.length) {
+            string line = string_eat_line(&str);
+            while (line.length) { sum += string_eat_token(&line, ' ').length; }
+        }
+    });
+    
+    bench(old_ns, 1, {
+        string str = string(text, length);
+        while (str.length) {
+            string line = old_eat_line(&str);
+            while (line.length) { sum += old_eat_token(&line, ' ').length; }
+        }
+    });
+    
+    bench(count_ns, 1, { sum += string_count_occurence(string(text, length), '\n'); });
+    bench(old_count_ns, 1, { sum += old_count_occurence(string(text, length), '\n'); });
+    
+    test_sink += sum;
+    
+    report_throughput("lines and tokens", length, new_ns * 1e-9);
+    report_throughput("lines and tokens, old loops", length, old_ns * 1e-9);
+    report_throughput("string_count_occurence", length, count_ns * 1e-9);
+    report_throughput("string_count_occurence, old loop", length, old_count_ns * 1e-9);
+    
+    check_message(new_ns <= old_ns, "walking lines and tokens took %.1f ms, with the old loops %.1f ms", new_ns * 1e-6, old_ns * 1e-6);
+    check_message(count_ns <= old_count_ns, "string_count_occurence took %.1f ms, the old loop %.1f ms", count_ns * 1e-6, old_count_ns * 1e-6);
+    
+    free(text);
+}
+
+int main() {
+    test_random_slices();
+    test_slice_ends();
+    bench_walk();
+    
+    return test_finish("string_scan");
+}
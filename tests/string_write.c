@@ -0,0 +1,293 @@
+// @Info: string_write for numbers. Shortest doubles and floats have to read back as the same bits, fixed places have
+//        to match rounding the shortest digits half away from zero (done here on the text printf gives), integers
+//        have to read back in every base. Then how many numbers per second each kind writes, next to snprintf.
+//
+//        The changes to prec and base for floats that the @Note at string_write_args lists are checked on their own.
+
+#include "test.h"
+#include "../source/vector.c"
+#include "../source/string.c"
+
+#include <math.h>
+
+#define RANDOM_VALUE_COUNT 100000
+#define BENCH_VALUE_COUNT  1000000
+
+static char* written_text(string* s) {
+    s->data[s->length] = 0;
+    return s->data;
+}
+
+static double random_double() {
+    union { unsigned long long bits; double value; } random_bits;
+    switch (test_random_int(0, 3)) {
+        case 0: {
+            do { random_bits.bits = test_random(); } while (isnan(random_bits.value) || isinf(random_bits.value));
+            return random_bits.value;
+        }
+        case 1:  return test_random_float(-1, 1);
+        case 2:  return (test_random_unit() - 0.5) * pow(10, test_random_int(-8, 12));
+        default: return (double)test_random_int(-100000, 100000) / pow(10, test_random_int(0, 6));
+    }
+}
+
+// @Info: the significant digits of a written number, without sign, point, leading and trailing zeros and exponent
+static int significant_digit_count(char* text) {
+    int first = -1, last = -1, index = 0;
+    for (char* c = text; *c && *c != 'e'; c++) {
+        if (*c < '0' || *c > '9') { continue; }
+        if (*c != '0') {
+            if (first < 0) { first = index; }
+            last = index;
+        }
+        index++;
+    }
+    return first < 0 ? 1 : last - first + 1;
+}
+
+// @Info: the fewest digits %e needs so strtod gives x back
+static int shortest_digit_count(double x, char* text) {
+    for (int digits = 1; digits < 17; digits++) {
+        sprintf(text, "%.*e", digits - 1, x);
+        if (strtod(text, 0) == x) { return digits; }
+    }
+    sprintf(text, "%.16e", x);
+    return 17;
+}
+
+static void test_shortest_round_trip() {
+    char text[512], reference[64];
+    string s = { .data = text, .size = sizeof(text) - 1 };
+    
+    for (int i = 0; i < RANDOM_VALUE_COUNT; i++) {
+        double x = random_double();
+        
+        s.length = 0;
+        int written = string_write(&s, x, .prec = STRING_WRITE_SHORTEST);
+        char* result = written_text(&s);
+        
+        char* end;
+        double back = strtod(result, &end);
+        check_message(written == (int)s.length && *end == 0 && memcmp(&back, &x, sizeof(double)) == 0,
+                      "%.17g was written as \"%s\", that reads back as %.17g", x, result, back);
+        
+        int shortest = shortest_digit_count(x, reference);
+        check_message(significant_digit_count(result) == shortest, "%.17g was written as \"%s\", %s is shorter", x, result, reference);
+        
+        // @Note: the parser of string.c has to read it back the same, that is the round trip the game does
+        string parse = string(text, s.length);
+        back = string_eat_double(&parse);
+        check_message(memcmp(&back, &x, sizeof(double)) == 0 && parse.length == 0, "string_eat_double reads \"%s\" as %.17g", result, back);
+        
+        float f = (float)x;
+        if (isinf(f)) { continue; }
+        
+        s.length = 0;
+        string_write(&s, f, .prec = STRING_WRITE_SHORTEST);
+        result = written_text(&s);
+        
+        float float_back = strtof(result, 0);
+        check_message(memcmp(&float_back, &f, sizeof(float)) == 0, "float %.9g was written as \"%s\", that reads back as %.9g", f, result, float_back);
+    }
+    
+    double specials[] = { 0.0, -0.0, 1.0, 0.1, 1e21, 1e-7, 5e-324, 2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0 };
+    for (int i = 0; i < (int)(sizeof(specials) / sizeof(specials[0])); i++) {
+        s.length = 0;
+        string_write(&s, specials[i], .prec = STRING_WRITE_SHORTEST);
+        double back = strtod(written_text(&s), 0);
+        check_message(memcmp(&back, &specials[i], sizeof(double)) == 0, "%.17g was written as \"%s\"", specials[i], text);
+    }
+}
+
+// @Info: prec places from the shortest digits, rounded half away from zero, done on the digits printf gives
+static void reference_fixed(double x, int prec, char* out) {
+    char shortest[64];
+    shortest_digit_count(x, shortest);
+    
+    // @Note: shortest is [-]d.ddde[+-]x, digit i has the weight 10^(point - 1 - i)
+    int digits[20], count = 0;
+    char* c = shortest + (shortest[0] == '-');
+    for (; *c != 'e'; c++) { if (*c != '.') { digits[count++] = *c - '0'; } }
+    int point = atoi(c + 1) + 1;
+    
+    // @Note: place j has the weight 10^(integer_count - j), place 0 is room for a carry
+    int integer_count = MAX(point, 1);
+    int place_count = integer_count + 1 + prec;
+    int places[64] = { 0 };
+    
+    for (int i = 0; i < count; i++) {
+        int j = integer_count - point + 1 + i;
+        if (j >= 0 && j < place_count) { places[j] = digits[i]; }
+    }
+    
+    int next = place_count - integer_count + point - 1;
+    if (next >= 0 && next < count && digits[next] >= 5) {
+        for (int j = place_count - 1; j >= 0; j--) {
+            if (++places[j] < 10) { break; }
+            places[j] = 0;
+        }
+    }
+    
+    char* o = out;
+    if (signbit(x)) { *o++ = '-'; }
+    
+    int first = 0;
+    while (first < integer_count && places[first] == 0) { first++; }
+    for (int j = first; j <= integer_count; j++) { *o++ = '0' + places[j]; }
+    
+    if (prec > 0) {
+        *o++ = '.';
+        for (int j = integer_count + 1; j < place_count; j++) { *o++ = '0' + places[j]; }
+    }
+    *o = 0;
+}
+
+static void test_fixed_places() {
+    char text[512], reference[512];
+    string s = { .data = text, .size = sizeof(text) - 1 };
+    
+    for (int i = 0; i < RANDOM_VALUE_COUNT; i++) {
+        double x = random_double();
+        if (ABS(x) > 1e25 || (ABS(x) < 1e-30 && x != 0)) { x = test_random_float(-1000, 1000); }
+        int prec = test_random_int(0, 9);
+        
+        s.length = 0;
+        string_write(&s, x, .prec = prec);
+        char* result = written_text(&s);
+        reference_fixed(x, prec, reference);
+        
+        check_message(strcmp(result, reference) == 0, "%.17g with prec %d was written as \"%s\", expected \"%s\"", x, prec, result, reference);
+    }
+}
+
+static void test_documented_changes() {
+    char text[512];
+    string s = { .data = text, .size = sizeof(text) - 1 };
+    
+    struct { double x; int prec; int base; char* expected; } cases[] = {
+        { 1.999999, 5, 10, "2.00000" },  // @Note: used to be cut off to "1.99999"
+        { 1.0,      5, 10, "1.00000" },  // @Note: used to be "1.0"
+        { 1.005,    2, 10, "1.01" },
+        { -2.5,     0, 10, "-3" },
+        { 255.5,    1, 16, "255.5" },    // @Note: base is ignored, used to be "FF.5"
+        { -0.0,     2, 10, "-0.00" },
+        { 3e9,      1, 10, "3000000000.0" }, // @Note: used to overflow the int it went through
+    };
+    
+    for (int i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+        s.length = 0;
+        int written = string_write(&s, cases[i].x, .prec = cases[i].prec, .base = cases[i].base);
+        char* result = written_text(&s);
+        check_message(strcmp(result, cases[i].expected) == 0 && written == (int)strlen(cases[i].expected),
+                      "%g with prec %d, base %d was written as \"%s\", expected \"%s\"", cases[i].x, cases[i].prec, cases[i].base, result, cases[i].expected);
+    }
+    
+    // @Note: too little room writes nothing
+    char small_data[4];
+    string small = { .data = small_data, .size = sizeof(small_data) };
+    check(string_write(&small, 12345.5) == 0 && small.length == 0);
+    check(string_write(&small, 123456) == 0 && small.length == 0);
+}
+
+static void test_int_round_trip() {
+    char text[128];
+    string s = { .data = text, .size = sizeof(text) - 1 };
+    
+    for (int i = 0; i < RANDOM_VALUE_COUNT; i++) {
+        long long x = (long long)test_random() >> test_random_int(0, 63);
+        int base = test_random_int(2, 16);
+        unsigned int minimum_digit_count = test_random_int(0, 3) ? 0 : test_random_int(1, 30);
+        
+        s.length = 0;
+        int written = string_write(&s, x, .base = base, .minimum_digit_count = minimum_digit_count);
+        char* result = written_text(&s);
+        
+        char* end;
+        long long back = strtoll(result, &end, base);
+        int digit_count = (int)s.length - (x < 0);
+        check_message(back == x && *end == 0 && written == (int)s.length && digit_count >= (int)minimum_digit_count,
+                      "%lld in base %d with %u digits was written as \"%s\"", x, base, minimum_digit_count, result);
+    }
+    
+    long long limits[] = { 0, -1, 9223372036854775807LL, -9223372036854775807LL - 1 };
+    for (int i = 0; i < 4; i++) {
+        s.length = 0;
+        string_write(&s, limits[i]);
+        check_message(strtoll(written_text(&s), 0, 10) == limits[i], "%lld was written as \"%s\"", limits[i], text);
+    }
+}
+
+static void report_numbers(char* name, double ns, double snprintf_ns) {
+    printf("  %-24s %8.1f M numbers/s   snprintf %8.1f M numbers/s\n", name, 1e3 / ns, 1e3 / snprintf_ns);
+}
+
+#define BENCH_WRITE(ns, values, ...) do {                                                  \
+        int total = 0;                                                                     \
+        bench(ns, BENCH_VALUE_COUNT, for (int i = 0; i < BENCH_VALUE_COUNT; i++) {         \
+            s.length = 0;                                                                  \
+            total += string_write(&s, values[i], __VA_ARGS__);                             \
+        });                                                                                \
+        test_sink += total;                                                                \
+    } while (0)
+
+#define BENCH_SNPRINTF(ns, values, format) do {                                            \
+        int total = 0;                                                                     \
+        bench(ns, BENCH_VALUE_COUNT, for (int i = 0; i < BENCH_VALUE_COUNT; i++) {         \
+            total += snprintf(text, sizeof(text), format, values[i]);                      \
+        });                                                                                \
+        test_sink += total;                                                                \
+    } while (0)
+
+static void bench_write() {
+    char text[512];
+    string s = { .data = text, .size = sizeof(text) - 1 };
+    
+    double* doubles = malloc(BENCH_VALUE_COUNT * sizeof(double));
+    float* floats = malloc(BENCH_VALUE_COUNT * sizeof(float));
+    long long* ints = malloc(BENCH_VALUE_COUNT * sizeof(long long));
+    
+    // @Note: the kind of values the game writes, coordinates and counters
+    for (int i = 0; i < BENCH_VALUE_COUNT; i++) {
+        doubles[i] = test_random_float(-1000, 1000);
+        floats[i] = test_random_float(-1000, 1000);
+        ints[i] = test_random_int(-1000000, 1000000);
+    }
+    
+    double ns, snprintf_ns;
+    
+    BENCH_WRITE(ns, doubles, .prec = STRING_WRITE_SHORTEST);
+    BENCH_SNPRINTF(snprintf_ns, doubles, "%.17g");
+    report_numbers("double, shortest", ns, snprintf_ns);
+    check_time("write double, shortest", ns, 300);
+    
+    BENCH_WRITE(ns, doubles, .prec = 5);
+    BENCH_SNPRINTF(snprintf_ns, doubles, "%.5f");
+    report_numbers("double, 5 places", ns, snprintf_ns);
+    check_time("write double, 5 places", ns, 300);
+    check_message(ns < snprintf_ns, "5 places take %.1f ns, snprintf %.1f ns", ns, snprintf_ns);
+    
+    BENCH_WRITE(ns, floats, .prec = STRING_WRITE_SHORTEST);
+    BENCH_SNPRINTF(snprintf_ns, floats, "%.9g");
+    report_numbers("float, shortest", ns, snprintf_ns);
+    check_time("write float, shortest", ns, 300);
+    
+    BENCH_WRITE(ns, ints, .base = 10);
+    BENCH_SNPRINTF(snprintf_ns, ints, "%lld");
+    report_numbers("int", ns, snprintf_ns);
+    check_time("write int", ns, 100);
+    
+    free(doubles);
+    free(floats);
+    free(ints);
+}
+
+int main() {
+    test_shortest_round_trip();
+    test_fixed_places();
+    test_documented_changes();
+    test_int_round_trip();
+    
+    bench_write();
+    
+    return test_finish("string_write");
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+// @Info: what the programs in tests/ share. Each one is a standalone executable that prints what it measured and
+//        exits with 1 if any check failed. "./build.sh tests" builds them with optimizations and runs all of them.
+//
+//        Time limits are generous on purpose, they are there to catch a change that makes something several
+//        times slower, not to compare machines.
+//
+//        Tests of the string and vector code include those files directly. Tests of game code include
+//        game_module.c, that builds all of the game without calling any of it, so a test only runs what it calls
+//        and can set the platform function pointers it needs itself.
+
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int test_check_count;
+static int test_failure_count;
+
+#define check(expr) test_check((expr) != 0, #expr, __FILE__, __LINE__)
+#define check_message(expr, ...) do {                                                                       \
+        if (!test_check((expr) != 0, #expr, __FILE__, __LINE__) && test_failure_count <= TEST_PRINTED_FAILURES) { \
+            printf("    "); printf(__VA_ARGS__); printf("\n");                                                    \
+        }                                                                                                    \
+    } while (0)
+
+// @Note: a broken loop over random inputs would print thousands of lines otherwise
+#define TEST_PRINTED_FAILURES 20
+
+static inline int test_check(int passed, char* expr, char* file, int line) {
+    test_check_count++;
+    if (passed) { return 1; }
+
+    if (++test_failure_count <= TEST_PRINTED_FAILURES) { printf("%s:%d: check failed: %s\n", file, line, expr); }
+    return 0;
+}
+
+static inline double test_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// @Info: xorshift64*, seeded the same every run so a failure can be reproduced
+static unsigned long long test_random_state = 0x9E3779B97F4A7C15ull;
+
+static inline unsigned long long test_random() {
+    test_random_state ^= test_random_state >> 12;
+    test_random_state ^= test_random_state << 25;
+    test_random_state ^= test_random_state >> 27;
+    return test_random_state * 0x2545F4914F6CDD1Dull;
+}
+
+// @Info: in [0, 1)
+static inline double test_random_unit() {
+    return (test_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline float test_random_float(float min, float max) {
+    return min + (max - min) * (float)test_random_unit();
+}
+
+static inline int test_random_int(int min, int max) {
+    return min + (int)(test_random() % (unsigned long long)(max - min + 1));
+}
+
+// @Info: benchmarks add their results into this, so the compiler can not drop the work
+static volatile double test_sink;
+
+// @Info: runs the statements a few times and keeps the fastest run, in nanoseconds per operation
+#define bench(ns_per_op, op_count, ...) do {                                     \
+        double best_ = 1e30;                                                     \
+        for (int round_ = 0; round_ < 5; round_++) {                             \
+            double start_ = test_seconds();                                      \
+            __VA_ARGS__;                                                         \
+            double time_ = test_seconds() - start_;                              \
+            if (time_ < best_) { best_ = time_; }                                \
+        }                                                                        \
+        (ns_per_op) = best_ * 1e9 / (double)(op_count);                          \
+    } while (0)
+
+static inline void report_time(char* name, double ns_per_op) {
+    printf("  %-32s %10.2f ns/op\n", name, ns_per_op);
+}
+
+static inline void check_time(char* name, double ns_per_op, double limit) {
+    printf("  %-32s %10.2f ns/op   (limit %g)\n", name, ns_per_op, limit);
+    check_message(ns_per_op <= limit, "%s took %.2f ns/op, the limit is %g", name, ns_per_op, limit);
+}
+
+static inline void report_throughput(char* name, double bytes, double seconds) {
+    printf("  %-32s %10.1f MB/s\n", name, bytes / seconds / 1e6);
+}
+
+static inline int test_finish(char* name) {
+    printf("%s: %d checks, %d failed\n", name, test_check_count, test_failure_count);
+    return test_failure_count ? 1 : 0;
+}
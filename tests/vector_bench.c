@@ -0,0 +1,386 @@
+// @Info: accuracy and speed of the math in vector.c, built from vector.c alone. Every function gets its largest
+//        error against a double precision reference and its time per call, both checked against the limits in
+//        the table below.
+//
+//        Errors are in float ulps at the magnitude of the result, where the magnitude is never taken below the
+//        scale of the function (the largest element of a matrix, 1 for sin). Otherwise an element that cancels to
+//        almost 0 would count its rounding noise in ulps of a tiny number. For sums of products the scale is the
+//        sum of the absolute products, that is how large the rounding errors of the terms can get.
+
+#include "test.h"
+#include "../source/vector.c"
+
+#define SAMPLE_COUNT 4096
+#define BENCH_REPEAT 256
+
+typedef struct {
+    char* name;
+    double max_ulp;
+    double max_ns;
+} math_limit;
+
+// @Note: the errors are what the current code measures with some room, the times are a few times what a
+//        2020s x64 desktop takes
+static math_limit limits[] = {
+    { "vec3_dot",            3,   5 },
+    { "vec3_cross",          2,   5 },
+    { "vec_norm (vec3)",     2,  10 },
+    { "vec3_transform",      3,  10 },
+    { "vec4_transform",      3,  10 },
+    { "mat4_mul",            3,  30 },
+    { "mat4_inv",           16,  60 },
+    { "quat_mul_quat",       2,  10 },
+    { "quat_to_mat",         6,  20 },
+    { "make_model_matrix",   2, 250 },
+    { "hermite",             2,  10 },
+    { "sin_approx",         48,  10 },
+    { "fast_sin",           48,  20 },
+};
+
+static math_limit* get_limit(char* name) {
+    for (int i = 0; i < (int)(sizeof(limits) / sizeof(limits[0])); i++) {
+        if (!strcmp(limits[i].name, name)) { return &limits[i]; }
+    }
+    return 0;
+}
+
+// === references
+
+static double ulp_error(double got, double expected, double scale) {
+    double magnitude = fmax(fabs(expected), scale);
+    int exponent;
+    frexp(magnitude, &exponent);
+    return fabs(got - expected) / ldexp(1.0, exponent - 24);
+}
+
+static double mat4_max_element(double m[4][4]) {
+    double result = 0;
+    for (int c = 0; c < 4; c++) for (int r = 0; r < 4; r++) { result = fmax(result, fabs(m[c][r])); }
+    return result;
+}
+
+static double mat4_ulp_error(mat4 got, double expected[4][4], double scale) {
+    double result = 0;
+    for (int c = 0; c < 4; c++) for (int r = 0; r < 4; r++) {
+        result = fmax(result, ulp_error(got.elements[c][r], expected[c][r], scale));
+    }
+    return result;
+}
+
+// @Info: returns the largest sum of absolute products as the scale of the result
+static double reference_mat4_mul(mat4 a, mat4 b, double out[4][4]) {
+    double scale = 0;
+    for (int c = 0; c < 4; c++) for (int r = 0; r < 4; r++) {
+        double sum = 0, magnitude = 0;
+        for (int k = 0; k < 4; k++) {
+            sum += (double)a.elements[k][r] * b.elements[c][k];
+            magnitude += fabs((double)a.elements[k][r] * b.elements[c][k]);
+        }
+        out[c][r] = sum;
+        scale = fmax(scale, magnitude);
+    }
+    return scale;
+}
+
+// @Info: gauss jordan with partial pivoting, on the elements as rows so it does not matter that they are columns
+static void reference_mat4_inv(mat4 m, double out[4][4]) {
+    double a[4][8];
+    for (int r = 0; r < 4; r++) for (int c = 0; c < 4; c++) {
+        a[r][c] = m.elements[c][r];
+        a[r][c + 4] = r == c;
+    }
+    
+    for (int pivot = 0; pivot < 4; pivot++) {
+        int best = pivot;
+        for (int r = pivot + 1; r < 4; r++) { if (fabs(a[r][pivot]) > fabs(a[best][pivot])) { best = r; } }
+        for (int c = 0; c < 8; c++) { double t = a[pivot][c]; a[pivot][c] = a[best][c]; a[best][c] = t; }
+        
+        double inv = 1.0 / a[pivot][pivot];
+        for (int c = 0; c < 8; c++) { a[pivot][c] *= inv; }
+        
+        for (int r = 0; r < 4; r++) {
+            if (r == pivot) { continue; }
+            double factor = a[r][pivot];
+            for (int c = 0; c < 8; c++) { a[r][c] -= factor * a[pivot][c]; }
+        }
+    }
+    
+    for (int r = 0; r < 4; r++) for (int c = 0; c < 4; c++) { out[c][r] = a[r][c + 4]; }
+}
+
+static void reference_quat_to_mat(quat q, double out[4][4]) {
+    double length = sqrt((double)q.x * q.x + (double)q.y * q.y + (double)q.z * q.z + (double)q.w * q.w);
+    double x = q.x / length, y = q.y / length, z = q.z / length, w = q.w / length;
+    
+    double m[4][4] = {
+        { 1 - 2 * (y * y + z * z),     2 * (x * y + w * z),     2 * (x * z - w * y), 0 },
+        {     2 * (x * y - w * z), 1 - 2 * (x * x + z * z),     2 * (y * z + w * x), 0 },
+        {     2 * (x * z + w * y),     2 * (y * z - w * x), 1 - 2 * (x * x + y * y), 0 },
+        {                       0,                       0,                       0, 1 },
+    };
+    memcpy(out, m, sizeof(m));
+}
+
+// === inputs
+
+static vec3 random_vec3(float range) {
+    return vec3(test_random_float(-range, range), test_random_float(-range, range), test_random_float(-range, range));
+}
+
+static quat random_quat() {
+    quat q = { .x = test_random_float(-1, 1), .y = test_random_float(-1, 1), .z = test_random_float(-1, 1), .w = test_random_float(-1, 1) };
+    return vec_norm(q);
+}
+
+// @Info: rotation, scale and translation like the game builds them, so the inverse is well conditioned
+static mat4 random_transform() {
+    vec3 scale = vec3(test_random_float(0.5, 2), test_random_float(0.5, 2), test_random_float(0.5, 2));
+    return make_model_matrix(random_vec3(100), scale, random_quat());
+}
+
+static mat4 random_matrix() {
+    mat4 result;
+    for (int c = 0; c < 4; c++) for (int r = 0; r < 4; r++) { result.elements[c][r] = test_random_float(-10, 10); }
+    return result;
+}
+
+static vec3 vectors_a[SAMPLE_COUNT], vectors_b[SAMPLE_COUNT];
+static vec4 points[SAMPLE_COUNT];
+static quat quats_a[SAMPLE_COUNT], quats_b[SAMPLE_COUNT];
+static mat4 matrices_a[SAMPLE_COUNT], matrices_b[SAMPLE_COUNT];
+static float scalars[SAMPLE_COUNT];
+static double angles[SAMPLE_COUNT];
+
+static void make_inputs() {
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        vectors_a[i] = random_vec3(100);
+        vectors_b[i] = random_vec3(100);
+        points[i] = (vec4){ .xyz = random_vec3(100), .w = 1 };
+        quats_a[i] = random_quat();
+        quats_b[i] = random_quat();
+        matrices_a[i] = random_matrix();
+        matrices_b[i] = random_transform();
+        scalars[i] = test_random_float(0, 1);
+        angles[i] = test_random_unit() * 2000 - 1000;
+    }
+}
+
+// === checks
+
+static void check_function(char* name, double max_ulp, double ns_per_op) {
+    math_limit* limit = get_limit(name);
+    printf("  %-20s %10.2f ulp %10.2f ns/op   (limits %g ulp, %g ns)\n", name, max_ulp, ns_per_op, limit->max_ulp, limit->max_ns);
+    check_message(max_ulp <= limit->max_ulp, "%s is off by %.2f ulp, the limit is %g", name, max_ulp, limit->max_ulp);
+    check_message(ns_per_op <= limit->max_ns, "%s took %.2f ns/op, the limit is %g", name, ns_per_op, limit->max_ns);
+}
+
+#define BENCH_LOOP(...) for (int repeat_ = 0; repeat_ < BENCH_REPEAT; repeat_++) for (int i = 0; i < SAMPLE_COUNT; i++) { __VA_ARGS__; }
+
+static void test_vector_functions() {
+    double error, ns;
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        vec3 a = vectors_a[i], b = vectors_b[i];
+        double expected = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z;
+        double scale = sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z) * sqrt((double)b.x * b.x + (double)b.y * b.y + (double)b.z * b.z);
+        error = fmax(error, ulp_error(vec_dot(a, b), expected, scale));
+    }
+    { float sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum += vec_dot(vectors_a[i], vectors_b[i]))); test_sink += sum; }
+    check_function("vec3_dot", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        vec3 a = vectors_a[i], b = vectors_b[i];
+        vec3 got = vec_cross(a, b);
+        double expected[3] = {
+            (double)a.y * b.z - (double)a.z * b.y,
+            (double)a.z * b.x - (double)a.x * b.z,
+            (double)a.x * b.y - (double)a.y * b.x };
+        double scale = sqrt((double)vec_dot(a, a)) * sqrt((double)vec_dot(b, b));
+        for (int k = 0; k < 3; k++) { error = fmax(error, ulp_error(got.elements[k], expected[k], scale)); }
+    }
+    { vec3 sum = {0}; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum = vec_add(sum, vec_cross(vectors_a[i], vectors_b[i])))); test_sink += sum.x; }
+    check_function("vec3_cross", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        vec3 a = vectors_a[i];
+        vec3 got = vec_norm(a);
+        double length = sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z);
+        for (int k = 0; k < 3; k++) { error = fmax(error, ulp_error(got.elements[k], a.elements[k] / length, 1)); }
+    }
+    { vec3 sum = {0}; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum = vec_add(sum, vec_norm(vectors_a[i])))); test_sink += sum.x; }
+    check_function("vec_norm (vec3)", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        mat4 m = matrices_b[i];
+        vec3 v = vectors_a[i];
+        vec3 got = vec_transform(m, v);
+        double scale = 0;
+        double expected[3];
+        for (int r = 0; r < 3; r++) {
+            expected[r] = (double)v.x * m.elements[0][r] + (double)v.y * m.elements[1][r] + (double)v.z * m.elements[2][r] + m.elements[3][r];
+            scale = fmax(scale, fabs(v.x * m.elements[0][r]) + fabs(v.y * m.elements[1][r]) + fabs(v.z * m.elements[2][r]) + fabs(m.elements[3][r]));
+        }
+        for (int r = 0; r < 3; r++) { error = fmax(error, ulp_error(got.elements[r], expected[r], scale)); }
+    }
+    { vec3 sum = {0}; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum = vec_add(sum, vec_transform(matrices_b[i], vectors_a[i])))); test_sink += sum.x; }
+    check_function("vec3_transform", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        mat4 m = matrices_a[i];
+        vec4 v = points[i];
+        vec4 got = vec_transform(m, v);
+        double scale = 0;
+        double expected[4];
+        for (int r = 0; r < 4; r++) {
+            expected[r] = 0;
+            double magnitude = 0;
+            for (int k = 0; k < 4; k++) {
+                expected[r] += (double)v.elements[k] * m.elements[k][r];
+                magnitude += fabs((double)v.elements[k] * m.elements[k][r]);
+            }
+            scale = fmax(scale, magnitude);
+        }
+        for (int r = 0; r < 4; r++) { error = fmax(error, ulp_error(got.elements[r], expected[r], scale)); }
+    }
+    { vec4 sum = {0}; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum = vec_add(sum, vec_transform(matrices_a[i], points[i])))); test_sink += sum.x; }
+    check_function("vec4_transform", error, ns);
+}
+
+static void test_matrix_functions() {
+    double error, ns;
+    double expected[4][4];
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        double scale = reference_mat4_mul(matrices_a[i], matrices_b[i], expected);
+        error = fmax(error, mat4_ulp_error(mat4_mul(matrices_a[i], matrices_b[i]), expected, scale));
+    }
+    { float sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT / 8, for (int repeat_ = 0; repeat_ < BENCH_REPEAT / 8; repeat_++) for (int i = 0; i < SAMPLE_COUNT; i++) { sum += mat4_mul(matrices_a[i], matrices_b[i]).elements[3][0]; }); test_sink += sum; }
+    check_function("mat4_mul", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        reference_mat4_inv(matrices_b[i], expected);
+        error = fmax(error, mat4_ulp_error(mat4_inv(matrices_b[i]), expected, mat4_max_element(expected)));
+    }
+    { float sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT / 8, for (int repeat_ = 0; repeat_ < BENCH_REPEAT / 8; repeat_++) for (int i = 0; i < SAMPLE_COUNT; i++) { sum += mat4_inv(matrices_b[i]).elements[3][0]; }); test_sink += sum; }
+    check_function("mat4_inv", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        quat a = quats_a[i], b = quats_b[i];
+        quat got = quat_mul_quat(a, b);
+        double e[4] = {
+            (double)a.w * b.x + (double)a.x * b.w + (double)a.y * b.z - (double)a.z * b.y,
+            (double)a.w * b.y - (double)a.x * b.z + (double)a.y * b.w + (double)a.z * b.x,
+            (double)a.w * b.z + (double)a.x * b.y - (double)a.y * b.x + (double)a.z * b.w,
+            (double)a.w * b.w - (double)a.x * b.x - (double)a.y * b.y - (double)a.z * b.z };
+        for (int k = 0; k < 4; k++) { error = fmax(error, ulp_error(got.elements[k], e[k], 1)); }
+    }
+    { quat sum = {0}; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum = vec_add(sum, quat_mul_quat(quats_a[i], quats_b[i])))); test_sink += sum.x; }
+    check_function("quat_mul_quat", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        reference_quat_to_mat(quats_a[i], expected);
+        error = fmax(error, mat4_ulp_error(quat_to_mat(quats_a[i]), expected, 1));
+    }
+    { float sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT / 8, for (int repeat_ = 0; repeat_ < BENCH_REPEAT / 8; repeat_++) for (int i = 0; i < SAMPLE_COUNT; i++) { sum += quat_to_mat(quats_a[i]).elements[1][0]; }); test_sink += sum; }
+    check_function("quat_to_mat", error, ns);
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        vec3 t = vectors_a[i];
+        vec3 s = vec3(1 + scalars[i], 2 - scalars[i], 0.5f + scalars[i]);
+        
+        double rotation[4][4];
+        reference_quat_to_mat(quats_a[i], rotation);
+        for (int c = 0; c < 3; c++) for (int r = 0; r < 4; r++) { expected[c][r] = rotation[c][r] * s.elements[c]; }
+        expected[3][0] = t.x, expected[3][1] = t.y, expected[3][2] = t.z, expected[3][3] = 1;
+        
+        error = fmax(error, mat4_ulp_error(make_model_matrix(t, s, quats_a[i]), expected, mat4_max_element(expected)));
+    }
+    { float sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT / 8, for (int repeat_ = 0; repeat_ < BENCH_REPEAT / 8; repeat_++) for (int i = 0; i < SAMPLE_COUNT; i++) { sum += make_model_matrix(vectors_a[i], vectors_b[i], quats_a[i]).elements[0][0]; }); test_sink += sum; }
+    check_function("make_model_matrix", error, ns);
+}
+
+static void test_scalar_functions() {
+    double error, ns;
+    
+    error = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        double t = scalars[i];
+        double expected = t * t * (3 - 2 * t);
+        error = fmax(error, ulp_error(hermite_interpolation(0, 1, scalars[i]), expected, 1));
+    }
+    { float sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum += hermite_interpolation(0, 1, scalars[i]))); test_sink += sum; }
+    check_function("hermite", error, ns);
+    
+    // @Note: errors in float ulps at 1, sin_approx and fast_sin return doubles but their error is an absolute one
+    double max_absolute = 0;
+    error = 0;
+    for (int i = 0; i <= 100000; i++) {
+        double x = -1.5707963267948966 + 3.141592653589793 * i / 100000;
+        double difference = fabs(sin_approx(x) - sin(x));
+        max_absolute = fmax(max_absolute, difference);
+        error = fmax(error, ulp_error(sin_approx(x), sin(x), 1));
+    }
+    { double sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum += sin_approx(scalars[i] * 3 - 1.5))); test_sink += sum; }
+    check_function("sin_approx", error, ns);
+    check_message(max_absolute <= 3.6e-6, "sin_approx is off by %g, the documented bound is 3.6e-6", max_absolute);
+    
+    max_absolute = 0;
+    error = 0;
+    for (int i = 0; i <= 1000000; i++) {
+        double x = -1000 + 2000.0 * i / 1000000;
+        double difference = fabs(fast_sin(x) - sin(x));
+        max_absolute = fmax(max_absolute, difference);
+        error = fmax(error, ulp_error(fast_sin(x), sin(x), 1));
+    }
+    { double sum = 0; bench(ns, SAMPLE_COUNT * BENCH_REPEAT, BENCH_LOOP(sum += fast_sin(angles[i]))); test_sink += sum; }
+    check_function("fast_sin", error, ns);
+    check_message(max_absolute <= 3.6e-6, "fast_sin is off by %g, the documented bound is 3.6e-6", max_absolute);
+}
+
+static void test_macros() {
+    check(ROUND(0.5) == 1);
+    check(ROUND(-0.5) == -1);
+    check(ROUND(1.49) == 1);
+    check(ROUND(-1.49) == -1);
+    check(ROUND(2.5) == 3);
+    check(ROUND(-2.5) == -3);
+    check(ROUND(0.0) == 0);
+    
+    check(FMOD(5.5, 2.0) == 1.5);
+    check(FMOD(-0.5, 2.0) == 1.5);
+    check(FMOD(-4.0, 2.0) == 0.0);
+    check(FMOD(7.0, 7.0) == 0.0);
+    
+    for (int i = 0; i < 10000; i++) {
+        double x = test_random_unit() * 200 - 100;
+        double m = 0.5 + test_random_unit() * 10;
+        double r = FMOD(x, m);
+        check_message(r >= 0 && r < m, "FMOD(%g, %g) = %g", x, m, r);
+        check_message(fabs(x - r - floor(x / m) * m) < 1e-9, "FMOD(%g, %g) = %g", x, m, r);
+        
+        int a = test_random_int(-1000, 1000), b = test_random_int(1, 50);
+        check_message(MOD(a, b) >= 0 && MOD(a, b) < b && (a - MOD(a, b)) % b == 0, "MOD(%d, %d) = %d", a, b, MOD(a, b));
+    }
+}
+
+int main() {
+    make_inputs();
+    
+    printf("vector.c, %s\n", VECTOR_SIMD_AVX2 ? "AVX2" : VECTOR_SIMD_SSE ? "SSE" : "scalar");
+    test_vector_functions();
+    test_matrix_functions();
+    test_scalar_functions();
+    test_macros();
+    
+    return test_finish("vector_bench");
+}
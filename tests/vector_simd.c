@@ -0,0 +1,135 @@
+// @Info: the simd versions in vector.c promise bit-identical results to their *_scalar versions, this checks that
+//        on random and on awkward inputs, and how much faster each one is. Built without simd (VECTOR_NO_SIMD, or
+//        not x64) both sides are the scalar version and there is nothing to compare.
+
+#include "test.h"
+#include "../source/vector.c"
+
+#define SAMPLE_COUNT 4096
+#define BENCH_REPEAT 64
+
+// @Note: the simd version may not be slower than the scalar one, quat_to_mat only gains a few percent so this leaves
+//        room for a noisy machine
+#define MIN_SPEEDUP 0.8
+
+static mat4 matrices_a[SAMPLE_COUNT], matrices_b[SAMPLE_COUNT];
+static vec4 vectors[SAMPLE_COUNT];
+static quat quats[SAMPLE_COUNT];
+
+static float random_component() {
+    // @Note: mostly ordinary numbers, some big and tiny ones and exact zeros so the signs of zero get compared too
+    switch (test_random_int(0, 15)) {
+        case 0:  return 0;
+        case 1:  return -0.0f;
+        case 2:  return test_random_float(-1e18f, 1e18f);
+        case 3:  return test_random_float(-1e-18f, 1e-18f);
+        default: return test_random_float(-100, 100);
+    }
+}
+
+static void make_inputs() {
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        for (int c = 0; c < 4; c++) for (int r = 0; r < 4; r++) {
+            matrices_a[i].elements[c][r] = random_component();
+            matrices_b[i].elements[c][r] = random_component();
+        }
+        for (int k = 0; k < 4; k++) {
+            vectors[i].elements[k] = random_component();
+            quats[i].elements[k] = random_component();
+        }
+    }
+    
+    // @Note: a few that are exact, so a difference is not hidden in rounding noise
+    matrices_a[0] = MAT4_ID();
+    matrices_b[1] = (mat4){0};
+    quats[0] = unit_quat();
+    quats[1] = vec4(0, 0, 0, -1);
+    quats[2] = vec4(1, 0, 0, 0);
+}
+
+static int same_bits(void* a, void* b, int size) {
+    return memcmp(a, b, size) == 0;
+}
+
+static void check_mat4(char* name, int i, mat4 simd, mat4 scalar) {
+    check_message(same_bits(&simd, &scalar, sizeof(mat4)), "%s differs from its scalar version for input %d", name, i);
+}
+
+static void test_bit_identical() {
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        check_mat4("mat4_mul", i, mat4_mul(matrices_a[i], matrices_b[i]), mat4_mul_scalar(matrices_a[i], matrices_b[i]));
+        check_mat4("mat4_inv", i, mat4_inv(matrices_a[i]), mat4_inv_scalar(matrices_a[i]));
+        check_mat4("quat_to_mat", i, quat_to_mat(quats[i]), quat_to_mat_scalar(quats[i]));
+        
+        vec4 simd = vec4_transform(matrices_a[i], vectors[i]);
+        vec4 scalar = vec4_transform_scalar(matrices_a[i], vectors[i]);
+        check_message(same_bits(&simd, &scalar, sizeof(vec4)), "vec4_transform differs from its scalar version for input %d", i);
+    }
+}
+
+static void compare_speed(char* name, double simd_ns, double scalar_ns) {
+    printf("  %-16s simd %8.2f ns/op   scalar %8.2f ns/op   %5.2fx\n", name, simd_ns, scalar_ns, scalar_ns / simd_ns);
+    if (VECTOR_SIMD_SSE) {
+        check_message(scalar_ns / simd_ns >= MIN_SPEEDUP, "%s is only %.2fx as fast as its scalar version", name, scalar_ns / simd_ns);
+    }
+}
+
+#define BENCH_MAT4(ns, function, ...) do {                                                                  \
+        float sum = 0;                                                                                      \
+        bench(ns, SAMPLE_COUNT * BENCH_REPEAT,                                                              \
+              for (int repeat = 0; repeat < BENCH_REPEAT; repeat++) for (int i = 0; i < SAMPLE_COUNT; i++) { \
+                  sum += function(__VA_ARGS__).elements[1][0];                                              \
+              });                                                                                           \
+        test_sink += sum;                                                                                   \
+    } while (0)
+
+static void test_speed() {
+    double simd, scalar;
+    
+    // @Note: new inputs without the huge and tiny values, products of those become denormals or infinities and the
+    //        time would be spent on those
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        for (int c = 0; c < 4; c++) for (int r = 0; r < 4; r++) {
+            matrices_a[i].elements[c][r] = test_random_float(-10, 10);
+            matrices_b[i].elements[c][r] = test_random_float(-10, 10);
+        }
+        for (int k = 0; k < 4; k++) {
+            vectors[i].elements[k] = test_random_float(-10, 10);
+            quats[i].elements[k] = test_random_float(-1, 1);
+        }
+    }
+    
+    BENCH_MAT4(simd, mat4_mul, matrices_a[i], matrices_b[i]);
+    BENCH_MAT4(scalar, mat4_mul_scalar, matrices_a[i], matrices_b[i]);
+    compare_speed("mat4_mul", simd, scalar);
+    
+    BENCH_MAT4(simd, mat4_inv, matrices_a[i]);
+    BENCH_MAT4(scalar, mat4_inv_scalar, matrices_a[i]);
+    compare_speed("mat4_inv", simd, scalar);
+    
+    BENCH_MAT4(simd, quat_to_mat, quats[i]);
+    BENCH_MAT4(scalar, quat_to_mat_scalar, quats[i]);
+    compare_speed("quat_to_mat", simd, scalar);
+    
+    {
+        vec4 sum = {0};
+        bench(simd, SAMPLE_COUNT * BENCH_REPEAT, for (int repeat = 0; repeat < BENCH_REPEAT; repeat++) for (int i = 0; i < SAMPLE_COUNT; i++) {
+            sum = vec_add(sum, vec4_transform(matrices_a[i], vectors[i]));
+        });
+        bench(scalar, SAMPLE_COUNT * BENCH_REPEAT, for (int repeat = 0; repeat < BENCH_REPEAT; repeat++) for (int i = 0; i < SAMPLE_COUNT; i++) {
+            sum = vec_add(sum, vec4_transform_scalar(matrices_a[i], vectors[i]));
+        });
+        test_sink += sum.x;
+        compare_speed("vec4_transform", simd, scalar);
+    }
+}
+
+int main() {
+    printf("vector.c simd against scalar, %s\n", VECTOR_SIMD_SSE ? "SSE" : "no simd in this build");
+    
+    make_inputs();
+    test_bit_identical();
+    test_speed();
+    
+    return test_finish("vector_simd");
+}